@@ -82,8 +82,8 @@
      uint16_t rt = 3;
      
      Config::SetDefault(
-         "ns3::CanlendarQueueDisc::MaxSize",
-         QueueSizeValue(QueueSize(QueueSizeUnit::BYTES, 0.5*10e6/8)));
+         "ns3::CanlendarQueueDisc::SlotCapacityBytes",
+         UintegerValue(0.5*10e6/8));
      
      
 
@@ -156,6 +156,13 @@ public:
     m_prefillCount  = prefillCount;
   }
 
+  // 设置 prefill 包和 decode 包的截止时间 (s)
+  void SetDeadlines (double prefillDeadline, double decodeDeadline)
+  {
+    m_prefillDeadline = prefillDeadline;
+    m_decodeDeadline  = decodeDeadline;
+  }
+
   void ReportStatistics () const
   {
     std::cout << "Sender to port " << m_remotePort << " statistics:" << std::endl;
@@ -289,7 +296,7 @@ private:
         //     ddlTag.SetDeadline(DeadlineTag::DDL_5S);
         //     break;
         //   }
-        ddlTag.SetDeadline(0.1);
+        ddlTag.SetDeadline(m_prefillDeadline);
         packet->AddPacketTag(ddlTag);
         packet->AddPacketTag(flowtype);
         m_socket->Send(packet);
@@ -327,7 +334,7 @@ private:
         //     ddlTag.SetDeadline(DeadlineTag::DDL_5S);
         //     break;
         //   }
-        ddlTag.SetDeadline(0.1);
+        ddlTag.SetDeadline(m_decodeDeadline);
         packet->AddPacketTag(ddlTag);
         packet->AddPacketTag(flowtype);
         m_socket->Send(packet);
@@ -373,6 +380,8 @@ private:
   uint32_t    m_decodeSize;
   uint32_t    m_decodeCount;
   uint32_t    m_prefillCount;   // 总的 prefill 包数量
+  double      m_prefillDeadline = 0.1;  // prefill 包的截止时间 (s)
+  double      m_decodeDeadline = 0.1;   // decode 包的截止时间 (s)
   uint32_t    m_prefillSent;    // 已发送的 prefill 包数量
   uint32_t    m_decodeSent;     // 已发送的 decode 包数量
   SenderPhase m_phase = PREFILL;
@@ -401,15 +410,29 @@ int main (int argc, char *argv[])
   //LogComponentEnable ("CanlendarQueueDisc", LOG_LEVEL_ALL);
   //LogComponentEnable ("FifoQueueDisc", LOG_LEVEL_ALL);
 
-  CommandLine cmd;
-  cmd.Parse (argc, argv);
-
   bool statement = true; 
   float rt = 0.01;      
-  uint32_t qz = 100;   
   uint32_t numd = 40000;
   uint32_t nump = 100;
   uint32_t flowsPerHost = 100;  
+  double stopTime = 500.0;
+  std::string leafSpineRate = "100Gbps";
+  double prefillDeadline = 0.1;
+  double decodeDeadline = 0.1;
+
+  // e.g. --statement=false --ns3::CanlendarQueueDisc::SlotOrdering=Edf
+  CommandLine cmd;
+  cmd.AddValue ("statement", "Use FifoQueueDisc (true) or CanlendarQueueDisc (false)", statement);
+  cmd.AddValue ("rt", "RotationInterval of CanlendarQueueDisc (s)", rt);
+  cmd.AddValue ("numd", "Number of decode packets per flow", numd);
+  cmd.AddValue ("nump", "Number of prefill packets per flow", nump);
+  cmd.AddValue ("flowsPerHost", "Number of flows sent by each host", flowsPerHost);
+  cmd.AddValue ("stopTime", "Simulation stop time (s)", stopTime);
+  cmd.AddValue ("leafSpineRate", "DataRate of the leaf-spine links", leafSpineRate);
+  cmd.AddValue ("prefillDeadline", "Deadline of the prefill packets (s)", prefillDeadline);
+  cmd.AddValue ("decodeDeadline", "Deadline of the decode packets (s)", decodeDeadline);
+  cmd.Parse (argc, argv);
+
   uint32_t hostsPerLeaf = 8; 
   uint32_t numLeaves = 4;
 
@@ -430,7 +453,7 @@ int main (int argc, char *argv[])
 
   // (a) leaf 与 spine 之间链路
   PointToPointHelper p2pLeafSpine;
-  p2pLeafSpine.SetDeviceAttribute ("DataRate", StringValue ("100Gbps"));
+  p2pLeafSpine.SetDeviceAttribute ("DataRate", StringValue (leafSpineRate));
   p2pLeafSpine.SetChannelAttribute ("Delay", StringValue ("1ms"));
   // (b) leaf 与 host 之间链路
   PointToPointHelper p2pLeafHost;
@@ -484,7 +507,6 @@ int main (int argc, char *argv[])
                   if (calQ)
                     {
                       calQ->SetAttribute ("RotationInterval", TimeValue (Seconds (rt)));
-                      calQ->SetQSize (qz);
                     }
                 }
             }
@@ -536,7 +558,7 @@ for (uint32_t i = 0; i < numHosts; ++i)
         receiverApp->Setup (hostAddresses[i], port);
         hostNodes.Get(i)->AddApplication(receiverApp);
         receiverApp->SetStartTime (Seconds(0.0));
-        receiverApp->SetStopTime (Seconds(500.0));
+        receiverApp->SetStopTime (Seconds(stopTime));
         receiverApps.push_back(receiverApp);
     }
 }
@@ -553,18 +575,19 @@ for (uint32_t i = 0; i < numHosts; ++i)
         uint16_t port = basePort + remoteIndex * flowsPerHost + j;
         Ptr<StopAndWaitSender> senderApp = CreateObject<StopAndWaitSender> ();
         senderApp->Setup (hostAddresses[remoteIndex], port, 1700 * 5, 5 * 512, numd, nump);
+        senderApp->SetDeadlines (prefillDeadline, decodeDeadline);
         hostNodes.Get(i)->AddApplication(senderApp);
         Ptr<ExponentialRandomVariable> interval = CreateObject<ExponentialRandomVariable> ();
         interval->SetAttribute ("Mean", DoubleValue (1.0 / 100));
         double nextInterval = interval->GetValue ();
         senderApp->SetStartTime (Seconds (nextInterval));
-        senderApp->SetStopTime (Seconds (500.0));
+        senderApp->SetStopTime (Seconds (stopTime));
         senderApps.push_back(senderApp);
     }
 }
 
 
-  Simulator::Stop (Seconds (500.0));
+  Simulator::Stop (Seconds (stopTime));
   Simulator::Run ();
   Simulator::Destroy ();
 
@@ -581,7 +604,7 @@ for (uint32_t i = 0; i < numHosts; ++i)
   // 统计所有流的耗时，计算平均耗时和最大耗时
   Time totalElapsed = Seconds(0);
   Time maxElapsed = Seconds(0);
-  Time minElapsed = Seconds(500);
+  Time minElapsed = Seconds(stopTime);
   uint32_t validFlows = 0;
   uint32_t validFlows2 = 0;
   Time totalpt =Seconds(0);
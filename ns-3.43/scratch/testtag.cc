@@ -414,8 +414,8 @@ int main (int argc, char *argv[])
   uint32_t flownum = 100;
   
   Config::SetDefault(
-      "ns3::CanlendarQueueDisc::MaxSize",
-      QueueSizeValue(QueueSize(QueueSizeUnit::BYTES, qz)));
+      "ns3::CanlendarQueueDisc::SlotCapacityBytes",
+      UintegerValue(qz));
 
 
 PointToPointHelper bottleNeckLink;
@@ -475,7 +475,6 @@ stack.Install(d.GetRight());
         if (canlendarQ)
         {
             canlendarQ->SetAttribute("RotationInterval", TimeValue(Seconds(rt))); 
-            canlendarQ->SetQSize(qz);
             std::cout << "time" << rt <<std::endl;
         }
       }
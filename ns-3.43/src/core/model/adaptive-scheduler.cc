@@ -0,0 +1,292 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "adaptive-scheduler.h"
+
+#include "assert.h"
+#include "double.h"
+#include "event-impl.h"
+#include "ladder-scheduler.h"
+#include "log.h"
+#include "map-scheduler.h"
+#include "object-factory.h"
+#include "priority-queue-scheduler.h"
+#include "uinteger.h"
+
+#include <algorithm>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::AdaptiveScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AdaptiveScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(AdaptiveScheduler);
+
+/** Insert() and RemoveNext() are timed once every this many calls. */
+static constexpr uint64_t SAMPLING_PERIOD = 16;
+
+TypeId
+AdaptiveScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AdaptiveScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<AdaptiveScheduler>()
+            .AddAttribute("Window",
+                          "The number of operations over which the statistics are collected.",
+                          UintegerValue(8192),
+                          MakeUintegerAccessor(&AdaptiveScheduler::m_windowOps),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("LadderSize",
+                          "The mean number of events from which the LadderScheduler is used.",
+                          UintegerValue(128),
+                          MakeUintegerAccessor(&AdaptiveScheduler::m_ladderSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CancelFraction",
+                          "The fraction of cancelled events above which the MapScheduler "
+                          "is used.",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&AdaptiveScheduler::m_cancelFraction),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("Hysteresis",
+                          "The number of windows in a row which must pick the same backend "
+                          "before migrating to it.",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&AdaptiveScheduler::m_hysteresis),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("CostTolerance",
+                          "The tolerated relative increase of the cost of the operations after "
+                          "a migration, beyond which the events are migrated back.",
+                          DoubleValue(0.25),
+                          MakeDoubleAccessor(&AdaptiveScheduler::m_costTolerance),
+                          MakeDoubleChecker<double>(0));
+    return tid;
+}
+
+AdaptiveScheduler::AdaptiveScheduler()
+    : m_previous(PriorityQueueScheduler::GetTypeId()),
+      m_candidate(PriorityQueueScheduler::GetTypeId()),
+      m_agreeing(0),
+      m_probation(false),
+      m_costBefore(0),
+      m_sizeBefore(0),
+      m_rejectedSize(0),
+      m_size(0),
+      m_calls(0),
+      m_nMigrations(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_backend = CreateObject<PriorityQueueScheduler>();
+}
+
+AdaptiveScheduler::~AdaptiveScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+AdaptiveScheduler::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_backend = nullptr;
+    Scheduler::DoDispose();
+}
+
+TypeId
+AdaptiveScheduler::GetBackend() const
+{
+    return m_backend->GetInstanceTypeId();
+}
+
+uint32_t
+AdaptiveScheduler::GetNMigrations() const
+{
+    return m_nMigrations;
+}
+
+void
+AdaptiveScheduler::Count()
+{
+    m_window.ops++;
+    m_window.sizes += m_size;
+}
+
+// No function logging in the per-event methods below, which the backend
+// already logs
+
+void
+AdaptiveScheduler::Insert(const Event& ev)
+{
+    if (++m_calls % SAMPLING_PERIOD == 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_backend->Insert(ev);
+        m_window.cost += std::chrono::steady_clock::now() - start;
+        m_window.samples++;
+    }
+    else
+    {
+        m_backend->Insert(ev);
+    }
+    m_size++;
+    m_window.inserts++;
+    Count();
+}
+
+bool
+AdaptiveScheduler::IsEmpty() const
+{
+    return m_backend->IsEmpty();
+}
+
+Scheduler::Event
+AdaptiveScheduler::PeekNext() const
+{
+    return m_backend->PeekNext();
+}
+
+Scheduler::Event
+AdaptiveScheduler::RemoveNext()
+{
+    Event ev;
+    if (++m_calls % SAMPLING_PERIOD == 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ev = m_backend->RemoveNext();
+        m_window.cost += std::chrono::steady_clock::now() - start;
+        m_window.samples++;
+    }
+    else
+    {
+        ev = m_backend->RemoveNext();
+    }
+    m_size--;
+    Count();
+    // The event is out of the backend, and the caller holds no reference
+    // into it: this is a safe point
+    if (m_window.ops >= m_windowOps)
+    {
+        EndWindow();
+    }
+    return ev;
+}
+
+void
+AdaptiveScheduler::Remove(const Event& ev)
+{
+    m_backend->Remove(ev);
+    m_size--;
+    m_window.removes++;
+    Count();
+}
+
+void
+AdaptiveScheduler::EndWindow()
+{
+    NS_LOG_FUNCTION(this);
+    Window window = m_window;
+    m_window = Window();
+
+    double size = window.sizes / window.ops;
+    double cancelled =
+        (window.inserts > 0) ? static_cast<double>(window.removes) / window.inserts : 0;
+    double cost =
+        (window.samples > 0)
+            ? std::chrono::duration<double, std::nano>(window.cost).count() / window.samples
+            : 0;
+    NS_LOG_DEBUG("Window of " << window.ops << " operations: size " << size << ", cancelled "
+                              << cancelled << ", cost " << cost << " ns with "
+                              << GetBackend().GetName());
+
+    // The cost of an operation grows with the number of events, whatever the
+    // backend, so only compare similar populations
+    auto similar = [](double a, double b) { return a < 2 * b && b < 2 * a; };
+
+    if (m_probation)
+    {
+        m_probation = false;
+        if (cost > 0 && m_costBefore > 0 && similar(size, m_sizeBefore) &&
+            cost > m_costBefore * (1 + m_costTolerance))
+        {
+            std::ostringstream reason;
+            reason << "operation cost " << cost << " ns, was " << m_costBefore << " ns";
+            m_rejected = GetBackend();
+            m_rejectedSize = size;
+            Migrate(m_previous, reason.str());
+            return;
+        }
+    }
+
+    if (window.inserts == 0)
+    {
+        // Nothing to tell about the new events while the events drain
+        return;
+    }
+
+    TypeId pick;
+    std::ostringstream reason;
+    if (cancelled > m_cancelFraction)
+    {
+        pick = MapScheduler::GetTypeId();
+        reason << "cancelled fraction " << cancelled << " > " << m_cancelFraction;
+    }
+    else if (size >= m_ladderSize &&
+             !(m_rejected == LadderScheduler::GetTypeId() && similar(size, m_rejectedSize)))
+    {
+        pick = LadderScheduler::GetTypeId();
+        reason << "mean size " << size << " >= " << m_ladderSize;
+    }
+    else
+    {
+        pick = PriorityQueueScheduler::GetTypeId();
+        reason << "cancelled fraction " << cancelled << ", mean size " << size;
+    }
+
+    m_agreeing = (pick == m_candidate) ? m_agreeing + 1 : 1;
+    m_candidate = pick;
+    if (pick == m_rejected && similar(size, m_rejectedSize))
+    {
+        NS_LOG_DEBUG("Keeping " << GetBackend().GetName() << ", " << pick.GetName()
+                                << " was rejected");
+        return;
+    }
+    if (pick != GetBackend() && m_agreeing >= m_hysteresis)
+    {
+        m_costBefore = cost;
+        m_sizeBefore = size;
+        Migrate(pick, reason.str());
+        m_probation = true;
+    }
+}
+
+void
+AdaptiveScheduler::Migrate(TypeId tid, const std::string& reason)
+{
+    NS_LOG_FUNCTION(this << tid.GetName() << reason);
+    NS_LOG_INFO("Migrating " << m_size << " events from " << GetBackend().GetName() << " to "
+                             << tid.GetName() << ": " << reason);
+    ObjectFactory factory;
+    factory.SetTypeId(tid);
+    Ptr<Scheduler> backend = factory.Create<Scheduler>();
+    while (!m_backend->IsEmpty())
+    {
+        backend->Insert(m_backend->RemoveNext());
+    }
+    m_previous = GetBackend();
+    m_backend = backend;
+    m_nMigrations++;
+    // The first operations on the new backend may reorganise the events it
+    // received, a one-off cost which is left out of the samples
+    m_calls = 0;
+}
+
+} // namespace ns3
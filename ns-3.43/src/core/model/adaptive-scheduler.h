@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef ADAPTIVE_SCHEDULER_H
+#define ADAPTIVE_SCHEDULER_H
+
+#include "ptr.h"
+#include "scheduler.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::AdaptiveScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief an event scheduler which migrates its events to the scheduler
+ * best suited to the current event population
+ *
+ * The events are stored in a backend scheduler, initially a
+ * PriorityQueueScheduler.
+ * Every Window operations, the scheduler looks at the operations of the
+ * window:
+ * - the mean number of pending events;
+ * - the fraction of the inserted events which were cancelled by Remove();
+ * - the mean wall-clock cost of Insert() and RemoveNext(), sampled every
+ *   16 calls.
+ *
+ * and picks the backend:
+ * - MapScheduler, when more than CancelFraction of the events are
+ *   cancelled, since the heap-based backends remove an event in linear
+ *   time;
+ * - LadderScheduler, when there are at least LadderSize events;
+ * - PriorityQueueScheduler otherwise, which is faster than the
+ *   HeapScheduler in bench-scheduler whatever the population.
+ *
+ * In an optimized build, the LadderScheduler is faster than the
+ * PriorityQueueScheduler from about a hundred events, both with the
+ * exponential horizons of bench-scheduler and when replaying a trace of
+ * leafspine, and faster than the CalendarScheduler whatever the
+ * population, which is hence not a candidate.
+ *
+ * The scheduler only migrates once the same backend has been picked for
+ * Hysteresis windows in a row, so that a short burst does not trigger a
+ * migration. The migration happens at a safe point, at the end of a
+ * RemoveNext(), by moving all the pending events to a new backend.
+ *
+ * The first window after a migration is a probation window. If the cost of
+ * the operations over this window, leaving out the first calls which may
+ * reorganise the migrated events, exceeds their cost before the migration
+ * by more than CostTolerance, the events are migrated back, and the
+ * rejected backend is not picked again until the number of events has
+ * halved or doubled. This notably protects against a backend
+ * degenerating when many events share a timestamp.
+ *
+ * All the backends remove the events in the same order, so the simulation
+ * results do not depend on the migrations, although the migrations
+ * themselves depend on the wall-clock cost. Each migration is logged at the
+ * LOG_INFO level of the AdaptiveScheduler log component, and the
+ * statistics of each window at the LOG_DEBUG level.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time       | Reason
+ * :----------- | :-------------------- | :-----
+ * Insert()     | Backend               | Statistics are constant time
+ * IsEmpty()    | Backend               |
+ * PeekNext()   | Backend               |
+ * Remove()     | Backend               |
+ * RemoveNext() | Backend               | A migration is amortized over a window
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                  | Reason
+ * :-------- | :---------------------- | :-----
+ * Overhead  | Backend + statistics    |
+ * Per Event | Backend                 | Only one backend holds the events
+ */
+class AdaptiveScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    AdaptiveScheduler();
+    /** Destructor. */
+    ~AdaptiveScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+    /**
+     * \return The type of the backend holding the events.
+     */
+    TypeId GetBackend() const;
+
+    /**
+     * \return The number of migrations so far.
+     */
+    uint32_t GetNMigrations() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /** The statistics of a window. */
+    struct Window
+    {
+        uint64_t ops{0};     /**< Number of operations. */
+        uint64_t inserts{0}; /**< Number of Insert(). */
+        uint64_t removes{0}; /**< Number of Remove(). */
+        double sizes{0};     /**< Sum of the number of events after each operation. */
+        uint64_t samples{0}; /**< Number of timed operations. */
+        std::chrono::steady_clock::duration cost{0}; /**< Time of the timed operations. */
+    };
+
+    /**
+     * Account for an operation in the window.
+     */
+    void Count();
+
+    /**
+     * Check the cost of a probation window, or pick a backend for the
+     * statistics of the window, and migrate if needed. This must only be
+     * called at a safe point.
+     */
+    void EndWindow();
+
+    /**
+     * Move all the events to a new backend.
+     *
+     * \param [in] tid The type of the new backend.
+     * \param [in] reason Why the new backend is better, for the log.
+     */
+    void Migrate(TypeId tid, const std::string& reason);
+
+    // Attributes
+    uint32_t m_windowOps;    /**< Number of operations per window. */
+    uint32_t m_ladderSize;   /**< Number of events from which the LadderScheduler is used. */
+    double m_cancelFraction; /**< Cancelled fraction above which the MapScheduler is used. */
+    uint32_t m_hysteresis;   /**< Number of windows agreeing before a migration. */
+    double m_costTolerance;  /**< Tolerated increase of the operation cost after a migration. */
+
+    Ptr<Scheduler> m_backend; /**< The backend holding the events. */
+    TypeId m_previous;        /**< The backend before the last migration. */
+    TypeId m_candidate;       /**< The backend picked by the last windows. */
+    uint32_t m_agreeing;      /**< Number of windows in a row picking m_candidate. */
+    bool m_probation;         /**< Whether the window is the first after a migration. */
+    double m_costBefore;      /**< Mean cost of the operations before the last migration (ns). */
+    double m_sizeBefore;      /**< Mean number of events before the last migration. */
+    TypeId m_rejected;        /**< The backend rejected by the last probation window. */
+    double m_rejectedSize;    /**< Mean number of events when m_rejected was rejected. */
+    uint64_t m_size;          /**< Number of events. */
+    uint64_t m_calls;         /**< Number of Insert() and RemoveNext(), to pick the ones to time. */
+    uint32_t m_nMigrations;   /**< Number of migrations. */
+    Window m_window;          /**< The statistics of the current window. */
+};
+
+} // namespace ns3
+
+#endif /* ADAPTIVE_SCHEDULER_H */
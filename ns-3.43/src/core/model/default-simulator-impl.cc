@@ -12,6 +12,7 @@
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
 #include <cmath>
 
@@ -37,7 +38,15 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("EventProfile",
+                                          "Prefix of the files where the wall-clock time spent "
+                                          "running each event function, in each context, is "
+                                          "written at Simulator::Destroy; empty to disable the "
+                                          "profiling",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_profilePrefix),
+                                          MakeStringChecker());
     return tid;
 }
 
@@ -51,7 +60,9 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_eventsWithContextStub.next = nullptr;
+    m_eventsWithContextHead = &m_eventsWithContextStub;
+    m_eventsWithContextTail = &m_eventsWithContextStub;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -89,6 +100,11 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+    if (m_profiler)
+    {
+        m_profiler->Write(m_profilePrefix);
+        m_profiler = nullptr;
+    }
 }
 
 void
@@ -130,7 +146,19 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (m_profiler)
+    {
+        // The event may destroy the object of its function
+        const void* function = next.impl->GetFunction();
+        auto start = EventProfiler::Clock::now();
+        next.impl->Invoke();
+        auto duration = EventProfiler::Clock::now() - start;
+        m_profiler->Record(next.impl, function, next.key.m_context, duration);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -143,32 +171,66 @@ DefaultSimulatorImpl::IsFinished() const
 }
 
 void
-DefaultSimulatorImpl::ProcessEventsWithContext()
+DefaultSimulatorImpl::PushEventWithContext(EventWithContext* ev)
+{
+    ev->next.store(nullptr, std::memory_order_relaxed);
+    EventWithContext* prev = m_eventsWithContextHead.exchange(ev, std::memory_order_acq_rel);
+    // Until this store, the consumer sees the queue as ending at prev
+    prev->next.store(ev, std::memory_order_release);
+}
+
+DefaultSimulatorImpl::EventWithContext*
+DefaultSimulatorImpl::PopEventWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    EventWithContext* tail = m_eventsWithContextTail;
+    EventWithContext* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_eventsWithContextStub)
     {
-        return;
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        m_eventsWithContextTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
     }
-
-    // swap queues
-    EventsWithContext eventsWithContext;
+    if (next != nullptr)
+    {
+        m_eventsWithContextTail = next;
+        return tail;
+    }
+    if (tail != m_eventsWithContextHead.load(std::memory_order_acquire))
     {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        // A producer is appending after the tail: try again later
+        return nullptr;
     }
-    while (!eventsWithContext.empty())
+    // The tail is the last event: put the stub behind it, to be able to
+    // remove it without racing with the producers
+    PushEventWithContext(&m_eventsWithContextStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        m_eventsWithContextTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void
+DefaultSimulatorImpl::ProcessEventsWithContext()
+{
+    EventWithContext* event;
+    while ((event = PopEventWithContext()) != nullptr)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
         Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
+        ev.impl = event->event;
+        ev.key.m_ts = m_currentTs + event->timestamp;
+        ev.key.m_context = event->context;
         ev.key.m_uid = m_uid;
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        delete event;
     }
 }
 
@@ -178,6 +240,10 @@ DefaultSimulatorImpl::Run()
     NS_LOG_FUNCTION(this);
     // Set the current threadId as the main threadId
     m_mainThreadId = std::this_thread::get_id();
+    if (!m_profilePrefix.empty() && !m_profiler)
+    {
+        m_profiler = std::make_unique<EventProfiler>();
+    }
     ProcessEventsWithContext();
     m_stop = false;
 
@@ -248,16 +314,12 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
     }
     else
     {
-        EventWithContext ev;
-        ev.context = context;
+        auto ev = new EventWithContext;
+        ev->context = context;
         // Current time added in ProcessEventsWithContext()
-        ev.timestamp = delay.GetTimeStep();
-        ev.event = event;
-        {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
-        }
+        ev->timestamp = delay.GetTimeStep();
+        ev->event = event;
+        PushEventWithContext(ev);
     }
 }
 
@@ -9,10 +9,13 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <thread>
 
 /**
@@ -84,19 +87,38 @@ class DefaultSimulatorImpl : public SimulatorImpl
         uint64_t timestamp;
         /** The event implementation. */
         EventImpl* event;
+        /** The next event in the queue of events from a different context. */
+        std::atomic<EventWithContext*> next;
     };
 
-    /** Container type for the events from a different context. */
-    typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * Append an event to the queue of events from a different context.
+     * Wait-free; called by any thread.
+     *
+     * \param [in] ev The event.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    void PushEventWithContext(EventWithContext* ev);
+    /**
+     * Remove the oldest event from the queue of events from a different
+     * context. Only called by the main thread.
+     *
+     * \return The event, or nullptr if there is none, or if the oldest event
+     * is still being appended.
+     */
+    EventWithContext* PopEventWithContext();
+
+    /**
+     * The events from a different context, in an intrusive multi-producer
+     * single-consumer queue: the producers atomically exchange the head,
+     * then link the previous head to the new event; the main thread
+     * consumes from the tail. The queue always holds at least the stub, so
+     * that the head and the tail are never null.
+     */
+    std::atomic<EventWithContext*> m_eventsWithContextHead;
+    /** The oldest event from a different context, or the stub. */
+    EventWithContext* m_eventsWithContextTail;
+    /** The placeholder of the empty queue of events from a different context. */
+    EventWithContext m_eventsWithContextStub;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
@@ -125,6 +147,11 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** Prefix of the event profile files, empty if not profiling. */
+    std::string m_profilePrefix;
+    /** The event profiler, if profiling. */
+    std::unique_ptr<EventProfiler> m_profiler;
 };
 
 } // namespace ns3
@@ -9,6 +9,10 @@
 #include "event-impl.h"
 
 #include "log.h"
+#include "pool-allocator.h"
+
+#include <cstdint>
+#include <cstring>
 
 /**
  * \file
@@ -21,6 +25,30 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+void*
+EventImpl::operator new(std::size_t size)
+{
+    return PoolAllocator::Allocate(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    PoolAllocator::Deallocate(p, size);
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */, std::align_val_t align)
+{
+    ::operator delete(p, align);
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -56,4 +84,54 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+const void*
+EventImpl::GetFunction() const
+{
+    return nullptr;
+}
+
+const void*
+EventImpl::GetMemberFunction(const void* function, std::size_t size, const void* obj)
+{
+#if defined(__GNUC__) && !defined(_MSC_VER)
+    // Itanium C++ ABI: the address of a non-virtual function, or the offset
+    // of a virtual function in the virtual table, followed by the adjustment
+    // of the object pointer; the ARM variant flags virtual functions in the
+    // adjustment rather than in the address
+    struct
+    {
+        uintptr_t ptr;
+        ptrdiff_t adj;
+    } pmf;
+
+    if (size != sizeof(pmf))
+    {
+        return nullptr;
+    }
+    std::memcpy(&pmf, function, sizeof(pmf));
+#if defined(__arm__) || defined(__aarch64__)
+    bool isVirtual = (pmf.adj & 1) != 0;
+    uintptr_t offset = pmf.ptr;
+    ptrdiff_t adj = pmf.adj >> 1;
+#else
+    bool isVirtual = (pmf.ptr & 1) != 0;
+    uintptr_t offset = pmf.ptr - 1;
+    ptrdiff_t adj = pmf.adj;
+#endif
+    if (!isVirtual)
+    {
+        return reinterpret_cast<const void*>(pmf.ptr);
+    }
+    if (obj == nullptr)
+    {
+        return nullptr;
+    }
+    const char* self = static_cast<const char*>(obj) + adj;
+    const char* vtable = *reinterpret_cast<const char* const*>(self);
+    return *reinterpret_cast<const void* const*>(vtable + offset);
+#else
+    return nullptr;
+#endif
+}
+
 } // namespace ns3
@@ -10,6 +10,8 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 /**
@@ -30,6 +32,11 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * EventImpl instances are short-lived and allocated at a high rate, so
+ * their memory is recycled through per-thread free lists, one per size
+ * class, instead of going back to the global allocator. An instance may
+ * be released by a thread other than the one which created it.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -55,6 +62,45 @@ class EventImpl : public SimpleRefCount<EventImpl>
      * Checked by the simulation engine before calling Invoke().
      */
     bool IsCancelled();
+    /**
+     * Identify the function called by this event, for profiling.
+     *
+     * \returns The address of the function, or nullptr if it is not known,
+     * for instance for a function object.
+     */
+    virtual const void* GetFunction() const;
+
+    /**
+     * Allocate the memory of an event from the PoolAllocator of the calling
+     * thread.
+     *
+     * \param [in] size The size of the event.
+     * \returns The allocated memory.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Return the memory of an event to the PoolAllocator of the calling thread.
+     *
+     * \param [in] p The memory to release.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * Allocate the memory of an over-aligned event, bypassing the PoolAllocator.
+     *
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     * \returns The allocated memory.
+     */
+    static void* operator new(std::size_t size, std::align_val_t align);
+    /**
+     * Release the memory of an over-aligned event.
+     *
+     * \param [in] p The memory to release.
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     */
+    static void operator delete(void* p, std::size_t size, std::align_val_t align);
 
   protected:
     /**
@@ -65,6 +111,19 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     virtual void Notify() = 0;
 
+    /**
+     * Resolve the address of the function called through a pointer to
+     * member function.
+     *
+     * \param [in] function The pointer to member function.
+     * \param [in] size The size of the pointer to member function.
+     * \param [in] obj The object the function is called on, converted to
+     * the class of the pointer to member function.
+     * \returns The address of the function, or nullptr if it cannot be
+     * resolved with the C++ ABI of the compiler.
+     */
+    static const void* GetMemberFunction(const void* function, std::size_t size, const void* obj);
+
   private:
     bool m_cancel; /**< Has this event been cancelled. */
 };
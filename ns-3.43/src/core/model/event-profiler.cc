@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "event-profiler.h"
+
+#include "abort.h"
+#include "demangle.h"
+#include "event-impl.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#ifndef __WIN32__
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+std::size_t
+EventProfiler::KeyHash::operator()(const Key& key) const
+{
+    std::size_t hash = std::hash<const void*>()(key.function);
+    hash = hash * 31 + key.type.hash_code();
+    return hash * 31 + key.context;
+}
+
+void
+EventProfiler::Record(const EventImpl* event,
+                      const void* function,
+                      uint32_t context,
+                      Clock::duration duration)
+{
+    Key key{function,
+            function ? std::type_index(typeid(void)) : std::type_index(typeid(*event)),
+            context};
+    Usage& usage = m_usage[key];
+    usage.count++;
+    usage.duration += duration;
+}
+
+std::string
+EventProfiler::GetName(const Key& key)
+{
+    if (key.function == nullptr)
+    {
+        // Name the events of MakeEvent(T function) after the function object
+        std::string name = Demangle(key.type.name());
+        const std::string makeEvent = "ns3::MakeEvent<";
+        if (name.starts_with(makeEvent))
+        {
+            std::size_t depth = 1;
+            for (std::size_t i = makeEvent.size(); i < name.size(); i++)
+            {
+                depth += (name[i] == '<') ? 1 : (name[i] == '>') ? -1 : 0;
+                if (depth == 0)
+                {
+                    return name.substr(makeEvent.size(), i - makeEvent.size());
+                }
+            }
+        }
+        return name;
+    }
+#ifndef __WIN32__
+    Dl_info info;
+    if (dladdr(key.function, &info) != 0 && info.dli_sname != nullptr)
+    {
+        return Demangle(info.dli_sname);
+    }
+#endif
+    std::ostringstream oss;
+    oss << key.function;
+    return oss.str();
+}
+
+void
+EventProfiler::Write(const std::string& prefix) const
+{
+    NS_LOG_FUNCTION(this << prefix);
+
+    std::map<const void*, std::string> functionNames;
+    std::map<std::string, Usage> byName;
+    std::map<uint32_t, Usage> byContext;
+    std::map<std::pair<uint32_t, std::string>, Clock::duration> stacks;
+    Clock::duration total{0};
+    for (const auto& [key, usage] : m_usage)
+    {
+        // Resolve each function once, whatever the number of contexts
+        std::string name;
+        if (key.function == nullptr)
+        {
+            name = GetName(key);
+        }
+        else
+        {
+            auto [it, inserted] = functionNames.try_emplace(key.function);
+            if (inserted)
+            {
+                it->second = GetName(key);
+            }
+            name = it->second;
+        }
+        byName[name].count += usage.count;
+        byName[name].duration += usage.duration;
+        byContext[key.context].count += usage.count;
+        byContext[key.context].duration += usage.duration;
+        stacks[{key.context, name}] += usage.duration;
+        total += usage.duration;
+    }
+
+    auto contextName = [](uint32_t context) {
+        return (context == Simulator::NO_CONTEXT) ? std::string("no context")
+                                                  : "node " + std::to_string(context);
+    };
+
+    std::ofstream flat(prefix + ".txt");
+    NS_ABORT_MSG_IF(!flat.is_open(), "Could not open " << prefix << ".txt");
+    auto writeTable = [&flat, total](const std::string& title, auto rows) {
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+            return a.second.duration > b.second.duration;
+        });
+        flat << "# " << title << "\n"
+             << "#      %      seconds       events     ns/event  name\n";
+        for (const auto& [name, usage] : rows)
+        {
+            double ns = std::chrono::duration<double, std::nano>(usage.duration).count();
+            double percent =
+                (total.count() > 0) ? 100.0 * usage.duration.count() / total.count() : 0;
+            flat << std::fixed << std::setw(8) << std::setprecision(2) << percent << " "
+                 << std::setw(12) << std::setprecision(6) << ns / 1e9 << " " << std::setw(12)
+                 << usage.count << " " << std::setw(12) << std::setprecision(1)
+                 << ns / usage.count << "  " << name << "\n";
+        }
+        flat << "\n";
+    };
+    writeTable("Wall-clock time by function",
+               std::vector<std::pair<std::string, Usage>>(byName.begin(), byName.end()));
+    std::vector<std::pair<std::string, Usage>> contexts;
+    for (const auto& [context, usage] : byContext)
+    {
+        contexts.emplace_back(contextName(context), usage);
+    }
+    writeTable("Wall-clock time by context", contexts);
+
+    std::ofstream folded(prefix + ".folded");
+    NS_ABORT_MSG_IF(!folded.is_open(), "Could not open " << prefix << ".folded");
+    for (const auto& [stack, duration] : stacks)
+    {
+        std::string name = stack.second;
+        std::replace(name.begin(), name.end(), ';', ':');
+        folded << contextName(stack.first) << ";" << name << " "
+               << std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() << "\n";
+    }
+}
+
+} // namespace ns3
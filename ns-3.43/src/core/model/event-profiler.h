@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Aggregate the wall-clock time spent running events by function
+ * and by context.
+ *
+ * Events are identified by the function they call, as returned by
+ * EventImpl::GetFunction() and resolved to its symbol name when the profile
+ * is written, or by the type of the event for the events calling a
+ * function object.
+ *
+ * Write() produces two files:
+ * - `<prefix>.txt`, a flat profile listing the functions, then the
+ *   contexts, by decreasing wall-clock time;
+ * - `<prefix>.folded`, the time of each function in each context in
+ *   nanoseconds, in the collapsed stack format of the FlameGraph tools,
+ *   with the context as the root frame.
+ *
+ * This is used by DefaultSimulatorImpl when its EventProfile attribute is
+ * set.
+ */
+class EventProfiler
+{
+  public:
+    /** The clock timing the events. */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Record the run of an event.
+     *
+     * The function of the event must be resolved before the event runs:
+     * EventImpl::GetFunction() may read the object of a member function,
+     * which the event may have destroyed.
+     *
+     * \param [in] event The event.
+     * \param [in] function The function called by the event, as returned by
+     *            EventImpl::GetFunction() before the event ran.
+     * \param [in] context The context of the event.
+     * \param [in] duration The wall-clock time spent running the event.
+     */
+    void Record(const EventImpl* event,
+                const void* function,
+                uint32_t context,
+                Clock::duration duration);
+
+    /**
+     * Write the profile.
+     *
+     * \param [in] prefix The prefix of the file names.
+     */
+    void Write(const std::string& prefix) const;
+
+  private:
+    /** What an event is accounted to. */
+    struct Key
+    {
+        const void* function; //!< The function called by the event, if known.
+        std::type_index type; //!< The type of the event, if the function is not known.
+        uint32_t context;     //!< The context of the event.
+
+        /**
+         * \param [in] o The other key.
+         * \return Whether the keys are equal.
+         */
+        bool operator==(const Key& o) const
+        {
+            return function == o.function && type == o.type && context == o.context;
+        }
+    };
+
+    /** Hash of a Key. */
+    struct KeyHash
+    {
+        /**
+         * \param [in] key The key.
+         * \return The hash of the key.
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /** Accumulated run time. */
+    struct Usage
+    {
+        uint64_t count{0};           //!< Number of events.
+        Clock::duration duration{0}; //!< Total wall-clock time.
+    };
+
+    /**
+     * \param [in] key A key.
+     * \return The name of the function of the key.
+     */
+    static std::string GetName(const Key& key);
+
+    /** The run time of each function in each context. */
+    std::unordered_map<Key, Usage, KeyHash> m_usage;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,311 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(0),
+      m_topMax(0),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+    // References to the buckets must survive the spawning of a new rung
+    m_rungs.reserve(MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::GetRungCurrent(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    m_size++;
+
+    if (ts >= m_topStart)
+    {
+        if (m_top.empty())
+        {
+            m_topMin = ts;
+            m_topMax = ts;
+        }
+        else
+        {
+            m_topMin = std::min(m_topMin, ts);
+            m_topMax = std::max(m_topMax, ts);
+        }
+        m_top.push_back(ev);
+        RefillBottom();
+        return;
+    }
+
+    for (std::size_t i = 0; i < m_nRungs; i++)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= GetRungCurrent(rung))
+        {
+            std::size_t bucket = (ts - rung.start) / rung.width;
+            NS_ASSERT(bucket < rung.nBuckets);
+            rung.buckets[bucket].push_back(ev);
+            rung.count++;
+            // The ladder may be left over from before the scheduler emptied
+            RefillBottom();
+            return;
+        }
+    }
+
+    InsertInBottom(ev);
+
+    // Too many events to keep sorted: spread them over a new lowest rung,
+    // unless they all share the same timestamp
+    if (m_bottom.size() - m_bottomHead > THRESHOLD && m_nRungs < MAX_RUNGS &&
+        m_bottom[m_bottomHead].key.m_ts != m_bottom.back().key.m_ts)
+    {
+        uint64_t end = (m_nRungs > 0) ? GetRungCurrent(m_rungs[m_nRungs - 1]) : m_topStart;
+        m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+        m_bottomHead = 0;
+        SpawnRung(m_bottom, m_bottom.front().key.m_ts, end);
+        m_bottom.clear();
+        RefillBottom();
+    }
+}
+
+void
+LadderScheduler::InsertInBottom(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl);
+    if (m_bottomHead > 0 && ev < m_bottom[m_bottomHead])
+    {
+        m_bottom[--m_bottomHead] = ev;
+        return;
+    }
+    // Reclaim the slots of the dequeued events before they dominate the vector
+    if (m_bottomHead > THRESHOLD && m_bottomHead > m_bottom.size() / 2)
+    {
+        m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+        m_bottomHead = 0;
+    }
+    auto it = std::upper_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+    m_bottom.insert(it, ev);
+}
+
+uint64_t
+LadderScheduler::SpawnRung(std::vector<Event>& events, uint64_t start, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << end);
+    NS_ASSERT(!events.empty() && end > start && m_nRungs < MAX_RUNGS);
+
+    uint64_t n = events.size();
+    uint64_t span = end - start;
+    uint64_t width = std::max<uint64_t>(1, span / n + (span % n != 0 ? 1 : 0));
+    uint64_t nBuckets = span / width + (span % width != 0 ? 1 : 0);
+
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs];
+    rung.start = start;
+    rung.width = width;
+    rung.nBuckets = nBuckets;
+    rung.current = 0;
+    rung.count = events.size();
+    if (rung.buckets.size() < nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    for (const auto& ev : events)
+    {
+        NS_ASSERT(ev.key.m_ts >= start && ev.key.m_ts < end);
+        rung.buckets[(ev.key.m_ts - start) / width].push_back(ev);
+    }
+    m_nRungs++;
+    return start + nBuckets * width;
+}
+
+void
+LadderScheduler::RefillBottom()
+{
+    NS_LOG_FUNCTION(this);
+    while (m_bottomHead == m_bottom.size() && m_size > 0)
+    {
+        m_bottom.clear();
+        m_bottomHead = 0;
+
+        if (m_nRungs == 0)
+        {
+            NS_ASSERT(!m_top.empty());
+            if (m_top.size() <= THRESHOLD)
+            {
+                std::sort(m_top.begin(), m_top.end());
+                m_bottom.swap(m_top);
+                m_topStart = m_topMax + 1;
+            }
+            else
+            {
+                m_topStart = SpawnRung(m_top, m_topMin, m_topMax + 1);
+                m_top.clear();
+            }
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        NS_ASSERT(rung.current < rung.nBuckets);
+        std::vector<Event>& bucket = rung.buckets[rung.current];
+        uint64_t bucketStart = GetRungCurrent(rung);
+        rung.current++;
+        rung.count -= bucket.size();
+
+        if (bucket.size() > THRESHOLD && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+            SpawnRung(bucket, bucketStart, bucketStart + rung.width);
+            bucket.clear();
+        }
+        else
+        {
+            std::sort(bucket.begin(), bucket.end());
+            m_bottom.swap(bucket);
+        }
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Event ev = m_bottom[m_bottomHead++];
+    m_size--;
+    RefillBottom();
+    NS_LOG_DEBUG("remove ts=" << ev.key.m_ts << ", uid=" << ev.key.m_uid << ", size=" << m_size);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+
+    auto swapErase = [&ev](std::vector<Event>& events) {
+        for (auto& item : events)
+        {
+            if (item.key.m_uid == ev.key.m_uid)
+            {
+                NS_ASSERT(ev.impl == item.impl);
+                item = events.back();
+                events.pop_back();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (ts >= m_topStart)
+    {
+        bool found [[maybe_unused]] = swapErase(m_top);
+        NS_ASSERT_MSG(found, "Event not found in the top");
+    }
+    else
+    {
+        std::size_t i = 0;
+        for (; i < m_nRungs; i++)
+        {
+            Rung& rung = m_rungs[i];
+            if (ts >= GetRungCurrent(rung))
+            {
+                bool found [[maybe_unused]] =
+                    swapErase(rung.buckets[(ts - rung.start) / rung.width]);
+                NS_ASSERT_MSG(found, "Event not found in the ladder");
+                rung.count--;
+                break;
+            }
+        }
+        if (i == m_nRungs)
+        {
+            auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+            NS_ASSERT_MSG(it != m_bottom.end() && it->key.m_uid == ev.key.m_uid,
+                          "Event not found in the bottom");
+            if (it == m_bottom.begin() + m_bottomHead)
+            {
+                m_bottomHead++;
+            }
+            else
+            {
+                m_bottom.erase(it);
+            }
+        }
+    }
+
+    m_size--;
+    RefillBottom();
+}
+
+} // namespace ns3
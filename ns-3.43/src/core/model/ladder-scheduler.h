@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue published in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang], in 2005.
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are stored in three tiers:
+ * - Top: an unsorted vector holding the events farther in the future
+ *   than any rung;
+ * - Ladder: up to MAX_RUNGS rungs, each made of a vector of buckets
+ *   covering a uniform time span; each rung covers one bucket of the rung
+ *   above it;
+ * - Bottom: a sorted vector holding the earliest events.
+ *
+ * Events are only sorted when they reach the bottom. When the bottom is
+ * empty, the next non-empty bucket of the lowest rung is moved to the
+ * bottom, unless it holds more than THRESHOLD events, in which case a
+ * finer rung is spawned from it. When the ladder is empty, the events in
+ * the top are spread over a new rung. Unlike the CalendarScheduler, the
+ * events are never redistributed all at once.
+ *
+ * The buckets, the rungs and the bottom are `std::vector`s which keep
+ * their capacity when emptied and are reused, so that, once the scheduler
+ * has reached a steady state, Insert and RemoveNext do not allocate memory.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Push in the top or in a bucket; insertion in the bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Head of the bottom
+ * Remove()     | ~Constant       | Search within the top or a bucket
+ * RemoveNext() | ~Constant       | Head of the bottom; amortized rung spawning
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x `std::vector` + rungs        | Top, bottom and ladder
+ * Per Event | 0                                | Events stored in `std::vector`s directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Maximum number of events moved to the bottom at once. */
+    static constexpr std::size_t THRESHOLD = 50;
+    /** Maximum number of rungs. */
+    static constexpr std::size_t MAX_RUNGS = 8;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;                          /**< Timestamp of the first bucket. */
+        uint64_t width;                          /**< Time span of each bucket. */
+        std::size_t nBuckets;                    /**< Number of buckets in use. */
+        std::size_t current;                     /**< First bucket not yet dequeued. */
+        std::size_t count;                       /**< Number of events in the rung. */
+        std::vector<std::vector<Event>> buckets; /**< The buckets. */
+    };
+
+    /**
+     * \param [in] rung The rung.
+     * \return The smallest timestamp that can be stored in the given rung.
+     */
+    static uint64_t GetRungCurrent(const Rung& rung);
+
+    /**
+     * Spread the given events over a new rung covering the time span
+     * [start, end).
+     *
+     * \param [in] events The events, all in [start, end).
+     * \param [in] start The start of the time span.
+     * \param [in] end The end of the time span.
+     * \return The end of the time span actually covered by the rung.
+     */
+    uint64_t SpawnRung(std::vector<Event>& events, uint64_t start, uint64_t end);
+
+    /** Move the earliest events to the bottom, if the bottom is empty. */
+    void RefillBottom();
+
+    /**
+     * Insert an event in the bottom, keeping it sorted.
+     *
+     * \param [in] ev The event.
+     */
+    void InsertInBottom(const Event& ev);
+
+    std::vector<Event> m_top;    /**< Events in the top. */
+    uint64_t m_topStart;         /**< Smallest timestamp of the events in the top. */
+    uint64_t m_topMin;           /**< Lower bound of the timestamps in the top. */
+    uint64_t m_topMax;           /**< Upper bound of the timestamps in the top. */
+    std::vector<Rung> m_rungs;   /**< The rungs; the first m_nRungs are in use. */
+    std::size_t m_nRungs;        /**< Number of rungs in use. */
+    std::vector<Event> m_bottom; /**< Sorted events, from index m_bottomHead. */
+    std::size_t m_bottomHead;    /**< Index of the earliest event in the bottom. */
+    std::size_t m_size;          /**< Number of events. */
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -126,6 +126,28 @@ struct EventMemberImplObjTraits<T*>
     }
 };
 
+/**
+ * \ingroup events
+ * Helper to find the class of a pointer to member.
+ *
+ * \tparam T \deduced The type of the pointer to member.
+ */
+template <typename T>
+struct MemberPointerClass;
+
+/**
+ * \ingroup events
+ * Helper to find the class of a pointer to member.
+ *
+ * \tparam M \deduced The type of the member.
+ * \tparam C \deduced The class of the member.
+ */
+template <typename M, typename C>
+struct MemberPointerClass<M C::*>
+{
+    using Type = C; //!< The class of the member.
+};
+
 } // namespace internal
 
 template <typename MEM, typename OBJ, typename... Ts>
@@ -138,7 +160,9 @@ MakeEvent(MEM mem_ptr, OBJ obj, Ts... args)
         EventMemberImpl() = delete;
 
         EventMemberImpl(OBJ obj, MEM function, Ts... args)
-            : m_function(std::bind(function, obj, args...))
+            : m_function(function),
+              m_obj(obj),
+              m_arguments(args...)
         {
         }
 
@@ -147,13 +171,29 @@ MakeEvent(MEM mem_ptr, OBJ obj, Ts... args)
         {
         }
 
+        const void* GetFunction() const override
+        {
+            if constexpr (std::is_member_function_pointer_v<MEM>)
+            {
+                using Class = typename internal::MemberPointerClass<MEM>::Type;
+                const Class* obj = &(*m_obj);
+                return GetMemberFunction(&m_function, sizeof(m_function), obj);
+            }
+            return nullptr;
+        }
+
       private:
         void Notify() override
         {
-            m_function();
+            std::apply([this](auto&... args) { std::invoke(m_function, m_obj, args...); },
+                       m_arguments);
         }
 
-        std::function<void()> m_function;
+        // Bound in place, rather than in a std::function, so that creating
+        // the event takes a single allocation
+        MEM m_function;
+        OBJ m_obj;
+        std::tuple<std::remove_reference_t<Ts>...> m_arguments;
     }* ev = new EventMemberImpl(obj, mem_ptr, args...);
 
     return ev;
@@ -177,6 +217,11 @@ MakeEvent(void (*f)(Us...), Ts... args)
         {
         }
 
+        const void* GetFunction() const override
+        {
+            return reinterpret_cast<const void*>(m_function);
+        }
+
       private:
         void Notify() override
         {
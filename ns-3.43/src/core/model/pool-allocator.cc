@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pool-allocator.h"
+
+#include "assert.h"
+#include "log.h"
+
+#include <atomic>
+#include <new>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::PoolAllocator implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PoolAllocator");
+
+namespace
+{
+
+/** A freed object, linked in the pool of its size class. */
+struct FreeObject
+{
+    FreeObject* next; //!< The next freed object of the pool
+};
+
+/** The pool of a size class. */
+struct Pool
+{
+    FreeObject* head{nullptr};    //!< The last freed object
+    PoolAllocator::Stats stats{}; //!< The statistics
+};
+
+/** Whether the objects are pooled, in all the threads. */
+std::atomic<bool> g_enabled{true};
+
+/**
+ * Whether the pools of the calling thread have been destroyed, in which
+ * case the objects freed during the thread exit, by other thread-local or
+ * static destructors, go to the heap.
+ */
+thread_local bool g_destroyed = false;
+
+/** The pools of a thread. */
+struct ThreadPools
+{
+    /** Release the pools when the thread exits. */
+    ~ThreadPools()
+    {
+        Release();
+        g_destroyed = true;
+    }
+
+    /** Return the memory held by the pools to the heap. */
+    void Release()
+    {
+        for (auto& pool : pools)
+        {
+            while (pool.head != nullptr)
+            {
+                FreeObject* object = pool.head;
+                pool.head = object->next;
+                ::operator delete(object);
+            }
+            pool.stats.pooled = 0;
+        }
+    }
+
+    Pool pools[PoolAllocator::SIZE_CLASSES]; //!< The pools, indexed by size class
+};
+
+/**
+ * \returns The pools of the calling thread.
+ */
+inline ThreadPools&
+GetThreadPools()
+{
+    static thread_local ThreadPools threadPools;
+    return threadPools;
+}
+
+/**
+ * \param [in] sizeClass The size class, in [0, SIZE_CLASSES).
+ * \returns The pool of the size class for the calling thread.
+ */
+inline Pool&
+GetPool(std::size_t sizeClass)
+{
+    return GetThreadPools().pools[sizeClass];
+}
+
+/**
+ * \param [in] size The size of an object.
+ * \returns The size class of \pname{size}.
+ */
+inline std::size_t
+GetSizeClass(std::size_t size)
+{
+    return size == 0 ? 0 : (size - 1) / PoolAllocator::GRANULARITY;
+}
+
+} // namespace
+
+// No logging in Allocate() and Deallocate(), which are called for every
+// event and packet, possibly before the log components are constructed
+
+void*
+PoolAllocator::Allocate(std::size_t size)
+{
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass >= SIZE_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    if (!g_destroyed && g_enabled.load(std::memory_order_relaxed))
+    {
+        Pool& pool = GetPool(sizeClass);
+        if (pool.head != nullptr)
+        {
+            FreeObject* object = pool.head;
+            pool.head = object->next;
+            pool.stats.hits++;
+            pool.stats.pooled--;
+            return object;
+        }
+        pool.stats.misses++;
+    }
+    // Large enough for any object of the size class, even when disabled,
+    // since the object may be freed to a pool once enabled again, or by a
+    // thread whose pools are alive
+    return ::operator new((sizeClass + 1) * GRANULARITY);
+}
+
+void
+PoolAllocator::Deallocate(void* ptr, std::size_t size)
+{
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass < SIZE_CLASSES && !g_destroyed && g_enabled.load(std::memory_order_relaxed))
+    {
+        Pool& pool = GetPool(sizeClass);
+        if (pool.stats.pooled < MAX_CACHED)
+        {
+            auto object = static_cast<FreeObject*>(ptr);
+            object->next = pool.head;
+            pool.head = object;
+            pool.stats.pooled++;
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+void
+PoolAllocator::SetEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+PoolAllocator::Stats
+PoolAllocator::GetStats(std::size_t sizeClass)
+{
+    NS_LOG_FUNCTION(sizeClass);
+    NS_ASSERT(sizeClass < SIZE_CLASSES);
+    return g_destroyed ? Stats{} : GetPool(sizeClass).stats;
+}
+
+PoolAllocator::Stats
+PoolAllocator::GetStats()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    Stats total;
+    for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASSES; ++sizeClass)
+    {
+        Stats stats = GetStats(sizeClass);
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.pooled += stats.pooled;
+    }
+    return total;
+}
+
+void
+PoolAllocator::ResetStats()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_destroyed)
+    {
+        return;
+    }
+    for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASSES; ++sizeClass)
+    {
+        Pool& pool = GetPool(sizeClass);
+        pool.stats.hits = 0;
+        pool.stats.misses = 0;
+    }
+}
+
+void
+PoolAllocator::PrintStats(std::ostream& os)
+{
+    NS_LOG_FUNCTION(&os);
+    for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASSES; ++sizeClass)
+    {
+        Stats stats = GetStats(sizeClass);
+        if (stats.hits + stats.misses + stats.pooled == 0)
+        {
+            continue;
+        }
+        uint64_t allocations = stats.hits + stats.misses;
+        os << "size<=" << (sizeClass + 1) * GRANULARITY << " hits=" << stats.hits
+           << " misses=" << stats.misses << " hit-rate="
+           << (allocations == 0 ? 0.0 : 100.0 * stats.hits / allocations)
+           << "% pooled=" << stats.pooled << std::endl;
+    }
+}
+
+void
+PoolAllocator::Release()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (!g_destroyed)
+    {
+        GetThreadPools().Release();
+    }
+}
+
+} // namespace ns3
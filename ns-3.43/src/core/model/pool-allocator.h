@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::PoolAllocator declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup core
+ *
+ * \brief Per-thread pools of the small objects allocated and freed for
+ * every event or packet
+ *
+ * The EventImpl objects, the Packet objects, the QueueItem objects (hence
+ * the QueueDiscItem and Ipv4QueueDiscItem objects) and the
+ * PacketTagList::TagData nodes are allocated from here, rather than
+ * individually from the heap.  The memory of each freed object is kept in
+ * the pool of its size class, a multiple of GRANULARITY bytes, and handed
+ * out again, last freed first, to the next object of this size class.
+ * Allocating a packet dequeued a moment ago thus reuses memory which is
+ * still in the cache.  A pool holds at most MAX_CACHED objects, so that a
+ * burst of packets does not keep its peak memory for the rest of the
+ * simulation.  The Buffer::Data and PacketMetadata::Data, whose sizes
+ * vary, keep their own free lists.
+ *
+ * Each thread has its own pools, so the pools need no locking and stay
+ * enabled in a multithreaded simulation.  The memory of the pooled
+ * objects comes from the heap, so that an object allocated by a thread
+ * can be freed by another one, which then keeps it in its own pools.
+ * The pools of a thread are released when it exits.
+ *
+ * An allocation served from a pool is a hit, one served from the heap a
+ * miss.  These statistics, per size class, are returned by GetStats(),
+ * and printed by PrintStats().  Release() returns the memory held by the
+ * pools to the heap, for example between two simulations in the same
+ * program.  The statistics and Release() are those of the pools of the
+ * calling thread.
+ */
+class PoolAllocator
+{
+  public:
+    /** The size classes are multiples of this number of bytes. */
+    static constexpr std::size_t GRANULARITY = 16;
+    /** The number of size classes; larger objects are not pooled. */
+    static constexpr std::size_t SIZE_CLASSES = 32;
+    /** The maximum number of freed objects held by the pool of a size class. */
+    static constexpr std::size_t MAX_CACHED = 4096;
+
+    /** The statistics of a size class, or of all of them. */
+    struct Stats
+    {
+        uint64_t hits{0};   //!< Allocations served from the pool
+        uint64_t misses{0}; //!< Allocations served from the heap
+        uint64_t pooled{0}; //!< Freed objects held by the pool
+    };
+
+    /**
+     * Allocate memory for an object.
+     *
+     * \param [in] size The size of the object.
+     * \returns The memory of the object.
+     */
+    static void* Allocate(std::size_t size);
+    /**
+     * Free the memory of an object, returning it to its pool.
+     *
+     * \param [in] ptr The memory of the object, returned by Allocate().
+     * \param [in] size The size of the object, as passed to Allocate().
+     */
+    static void Deallocate(void* ptr, std::size_t size);
+
+    /**
+     * Enable or disable the pools of all the threads.  When disabled, the
+     * objects are allocated from and freed to the heap, which is the
+     * reference for benchmarks.
+     *
+     * \param [in] enabled Whether to pool the objects.
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * \param [in] sizeClass The size class, in [0, SIZE_CLASSES).
+     * \returns The statistics of the objects of up to
+     *          (sizeClass + 1) * GRANULARITY bytes.
+     */
+    static Stats GetStats(std::size_t sizeClass);
+    /**
+     * \returns The statistics of all the size classes.
+     */
+    static Stats GetStats();
+    /** Reset the hits and misses of all the size classes. */
+    static void ResetStats();
+    /**
+     * Print the statistics of the size classes in use, one per line.
+     *
+     * \param [in,out] os The output stream.
+     */
+    static void PrintStats(std::ostream& os);
+
+    /** Return the memory held by the pools to the heap. */
+    static void Release();
+};
+
+} // namespace ns3
+
+#endif /* POOL_ALLOCATOR_H */
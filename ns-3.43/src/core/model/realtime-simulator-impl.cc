@@ -19,6 +19,7 @@
 #include "synchronizer.h"
 #include "wall-clock-synchronizer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <mutex>
 #include <thread>
@@ -75,6 +76,9 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
+    m_eventsWithContextStub.next = nullptr;
+    m_eventsWithContextHead = &m_eventsWithContextStub;
+    m_eventsWithContextTail = &m_eventsWithContextStub;
 
     m_main = std::this_thread::get_id();
 
@@ -92,6 +96,8 @@ void
 RealtimeSimulatorImpl::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    ProcessEventsWithContext();
+
     while (!m_events->IsEmpty())
     {
         Scheduler::Event next = m_events->RemoveNext();
@@ -193,6 +199,15 @@ RealtimeSimulatorImpl::ProcessOneEvent()
 
         {
             std::unique_lock lock{m_mutex};
+            //
+            // Reset the synchronizer before looking for the events scheduled by
+            // other threads, which do not take the critical section: one appended
+            // after we looked signals the synchronizer after this reset, and so
+            // interrupts the wait below.
+            //
+            m_synchronizer->SetCondition(false);
+            ProcessEventsWithContext();
+
             //
             // Since we are in realtime mode, the time to delay has got to be the
             // difference between the current realtime and the timestamp of the next
@@ -239,10 +254,9 @@ RealtimeSimulatorImpl::ProcessOneEvent()
             // We've figured out how long we need to delay in order to pace the
             // simulation time with the real time.  We're going to sleep, but need
             // to work with the synchronizer to make sure we're awakened if something
-            // external happens (like a packet is received).  This next line resets
-            // the synchronizer so that any future event will cause it to interrupt.
+            // external happens (like a packet is received).  The reset of the
+            // synchronizer above makes any future event interrupt it.
             //
-            m_synchronizer->SetCondition(false);
         }
 
         //
@@ -312,6 +326,7 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         // event we're working on won't be on the list and so subsequent operations won't
         // mess with us.
         //
+        ProcessEventsWithContext();
         NS_ASSERT_MSG(m_events->IsEmpty() == false,
                       "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
         next = m_events->RemoveNext();
@@ -396,6 +411,77 @@ RealtimeSimulatorImpl::IsFinished() const
     return rc;
 }
 
+void
+RealtimeSimulatorImpl::PushEventWithContext(EventWithContext* ev)
+{
+    ev->next.store(nullptr, std::memory_order_relaxed);
+    EventWithContext* prev = m_eventsWithContextHead.exchange(ev, std::memory_order_acq_rel);
+    // Until this store, the consumer sees the queue as ending at prev
+    prev->next.store(ev, std::memory_order_release);
+}
+
+RealtimeSimulatorImpl::EventWithContext*
+RealtimeSimulatorImpl::PopEventWithContext()
+{
+    EventWithContext* tail = m_eventsWithContextTail;
+    EventWithContext* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_eventsWithContextStub)
+    {
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        m_eventsWithContextTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr)
+    {
+        m_eventsWithContextTail = next;
+        return tail;
+    }
+    if (tail != m_eventsWithContextHead.load(std::memory_order_acquire))
+    {
+        // A producer is appending after the tail: try again later
+        return nullptr;
+    }
+    // The tail is the last event: put the stub behind it, to be able to
+    // remove it without racing with the producers
+    PushEventWithContext(&m_eventsWithContextStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        m_eventsWithContextTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+//
+// Should be called with critical section locked.
+//
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext()
+{
+    EventWithContext* event;
+    while ((event = PopEventWithContext()) != nullptr)
+    {
+        //
+        // The realtime clock read by the scheduling thread may be behind the
+        // events run since then: an event is never scheduled in the past.
+        //
+        Scheduler::Event ev;
+        ev.impl = event->event;
+        ev.key.m_ts = std::max(event->timestamp, m_currentTs);
+        ev.key.m_context = event->context;
+        ev.key.m_uid = m_uid;
+        m_uid++;
+        m_unscheduledEvents++;
+        m_events->Insert(ev);
+        delete event;
+    }
+}
+
 //
 // Peeks into event list.  Should be called with critical section locked.
 //
@@ -432,6 +518,7 @@ RealtimeSimulatorImpl::Run()
         {
             std::unique_lock lock{m_mutex};
 
+            ProcessEventsWithContext();
             if (!m_events->IsEmpty())
             {
                 process = true;
@@ -461,6 +548,7 @@ RealtimeSimulatorImpl::Run()
     {
         std::unique_lock lock{m_mutex};
 
+        ProcessEventsWithContext();
         NS_ASSERT_MSG(m_events->IsEmpty() == false || m_unscheduledEvents == 0,
                       "RealtimeSimulatorImpl::Run(): Empty queue and unprocessed events");
     }
@@ -531,24 +619,10 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
 {
     NS_LOG_FUNCTION(this << context << delay << impl);
 
+    if (m_main == std::this_thread::get_id())
     {
         std::unique_lock lock{m_mutex};
-        uint64_t ts;
-
-        if (m_main == std::this_thread::get_id())
-        {
-            ts = m_currentTs + delay.GetTimeStep();
-        }
-        else
-        {
-            //
-            // If the simulator is running, we're pacing and have a meaningful
-            // realtime clock.  If we're not, then m_currentTs is where we stopped.
-            //
-            ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
-            ts += delay.GetTimeStep();
-        }
-
+        uint64_t ts = m_currentTs + delay.GetTimeStep();
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
         Scheduler::Event ev;
@@ -561,6 +635,22 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
         m_events->Insert(ev);
         m_synchronizer->Signal();
     }
+    else
+    {
+        //
+        // If the simulator is running, we're pacing and have a meaningful
+        // realtime clock.  If we're not, then m_currentTs is where we stopped.
+        // The event is handed over to the main thread, which inserts it in the
+        // event list, so that this thread does not wait for the critical section.
+        //
+        auto ev = new EventWithContext;
+        ev->context = context;
+        ev->timestamp = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        ev->timestamp += delay.GetTimeStep();
+        ev->event = impl;
+        PushEventWithContext(ev);
+        m_synchronizer->Signal();
+    }
 }
 
 EventId
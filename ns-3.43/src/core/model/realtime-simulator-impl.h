@@ -15,6 +15,7 @@
 #include "simulator-impl.h"
 #include "synchronizer.h"
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
@@ -170,9 +171,43 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     uint64_t NextTs() const;
     /** Process the next event. */
     void ProcessOneEvent();
+    /**
+     * Move events from a different thread into the event list.  Only called
+     * by the main thread, with #m_mutex held.
+     */
+    void ProcessEventsWithContext();
     /** Destructor implementation. */
     void DoDispose() override;
 
+    /** Wrap an event scheduled by a different thread with its execution context. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event timestamp. */
+        uint64_t timestamp;
+        /** The event implementation. */
+        EventImpl* event;
+        /** The next event in the queue of events from a different thread. */
+        std::atomic<EventWithContext*> next;
+    };
+
+    /**
+     * Append an event to the queue of events from a different thread.
+     * Wait-free; called by any thread.
+     *
+     * \param [in] ev The event.
+     */
+    void PushEventWithContext(EventWithContext* ev);
+    /**
+     * Remove the oldest event from the queue of events from a different
+     * thread. Only called by the main thread.
+     *
+     * \return The event, or nullptr if there is none, or if the oldest event
+     * is still being appended.
+     */
+    EventWithContext* PopEventWithContext();
+
     /** Container type for events to be run at destroy time. */
     typedef std::list<EventId> DestroyEvents;
     /** Container for events to be run at destroy time. */
@@ -180,7 +215,18 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** Has the stopping condition been reached? */
     bool m_stop;
     /** Is the simulator currently running. */
-    bool m_running;
+    std::atomic<bool> m_running;
+
+    /**
+     * The events scheduled with a context by a different thread, in an
+     * intrusive multi-producer single-consumer queue, as in
+     * DefaultSimulatorImpl, so that these threads do not take #m_mutex.
+     */
+    std::atomic<EventWithContext*> m_eventsWithContextHead;
+    /** The oldest event from a different thread, or the stub. */
+    EventWithContext* m_eventsWithContextTail;
+    /** The placeholder of the empty queue of events from a different thread. */
+    EventWithContext m_eventsWithContextStub;
 
     /**
      * \name Mutex-protected variables.
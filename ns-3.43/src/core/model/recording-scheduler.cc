@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "recording-scheduler.h"
+
+#include "abort.h"
+#include "event-impl.h"
+#include "log.h"
+#include "map-scheduler.h"
+#include "object-factory.h"
+#include "string.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::RecordingScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RecordingScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(RecordingScheduler);
+
+TypeId
+RecordingScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::RecordingScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<RecordingScheduler>()
+            .AddAttribute("Backend",
+                          "The type of the scheduler holding the events.",
+                          TypeIdValue(MapScheduler::GetTypeId()),
+                          MakeTypeIdAccessor(&RecordingScheduler::m_backendTid),
+                          MakeTypeIdChecker())
+            .AddAttribute("FileName",
+                          "The name of the trace file of the operations.",
+                          StringValue("scheduler.trace"),
+                          MakeStringAccessor(&RecordingScheduler::m_fileName),
+                          MakeStringChecker());
+    return tid;
+}
+
+RecordingScheduler::RecordingScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RecordingScheduler::~RecordingScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+RecordingScheduler::NotifyConstructionCompleted()
+{
+    NS_LOG_FUNCTION(this);
+    ObjectFactory factory;
+    factory.SetTypeId(m_backendTid);
+    m_backend = factory.Create<Scheduler>();
+    m_file.open(m_fileName);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "Cannot open the trace file " << m_fileName);
+    Scheduler::NotifyConstructionCompleted();
+}
+
+void
+RecordingScheduler::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_backend = nullptr;
+    m_file.close();
+    Scheduler::DoDispose();
+}
+
+void
+RecordingScheduler::Record(char op, const Event& ev)
+{
+    m_file << op << ' ' << ev.key.m_ts << ' ' << ev.key.m_uid << '\n';
+}
+
+void
+RecordingScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    Record('i', ev);
+    m_backend->Insert(ev);
+}
+
+bool
+RecordingScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_backend->IsEmpty();
+}
+
+Scheduler::Event
+RecordingScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_backend->PeekNext();
+}
+
+Scheduler::Event
+RecordingScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    Event ev = m_backend->RemoveNext();
+    Record('r', ev);
+    return ev;
+}
+
+void
+RecordingScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    Record('c', ev);
+    m_backend->Remove(ev);
+}
+
+} // namespace ns3
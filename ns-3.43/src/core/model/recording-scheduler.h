@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RECORDING_SCHEDULER_H
+#define RECORDING_SCHEDULER_H
+
+#include "ptr.h"
+#include "scheduler.h"
+
+#include <fstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::RecordingScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief an event scheduler which records the operations on a backend
+ * scheduler to a trace file
+ *
+ * The events are stored in a backend scheduler, of type Backend, and every
+ * operation is appended to the file FileName, one per line, as the
+ * operation, the timestamp and the uid of the event:
+ * - `i <ts> <uid>` for Insert();
+ * - `r <ts> <uid>` for RemoveNext();
+ * - `c <ts> <uid>` for Remove(), that is an event removed by
+ *   Simulator::Remove().
+ *
+ * An event cancelled by Simulator::Cancel() stays in the scheduler: it is
+ * recorded as `r` when it expires, as are the events left in the scheduler
+ * when the simulator is destroyed.
+ *
+ * The timestamps are in units of the Time resolution. Such a trace of a
+ * real simulation can be replayed against each scheduler by
+ * `bench-scheduler --trace=<file>`, for example:
+ *
+ * \code
+ *   ./ns3 run "leafspine --SchedulerType=ns3::RecordingScheduler
+ *              --ns3::RecordingScheduler::FileName=leafspine.trace"
+ *   ./ns3 run "bench-scheduler --all --trace=leafspine.trace"
+ * \endcode
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time       | Reason
+ * :----------- | :-------------------- | :-----
+ * Insert()     | Backend               | Buffered write
+ * IsEmpty()    | Backend               |
+ * PeekNext()   | Backend               |
+ * Remove()     | Backend               | Buffered write
+ * RemoveNext() | Backend               | Buffered write
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                  | Reason
+ * :-------- | :---------------------- | :-----
+ * Overhead  | Backend + file buffer   |
+ * Per Event | Backend                 |
+ */
+class RecordingScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    RecordingScheduler();
+    /** Destructor. */
+    ~RecordingScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  protected:
+    void DoDispose() override;
+    void NotifyConstructionCompleted() override;
+
+  private:
+    /**
+     * Append an operation to the trace file.
+     *
+     * \param [in] op The operation.
+     * \param [in] ev The event.
+     */
+    void Record(char op, const Scheduler::Event& ev);
+
+    TypeId m_backendTid;      /**< The type of the backend. */
+    std::string m_fileName;   /**< The name of the trace file. */
+    Ptr<Scheduler> m_backend; /**< The backend holding the events. */
+    std::ofstream m_file;     /**< The trace file. */
+};
+
+} // namespace ns3
+
+#endif /* RECORDING_SCHEDULER_H */
@@ -13,6 +13,10 @@
 #include "log.h"
 #include "uinteger.h"
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup randomvariable
@@ -29,7 +33,11 @@ NS_LOG_COMPONENT_DEFINE("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
+#ifdef NS3_MTP
+static std::atomic<uint64_t> g_nextStreamIndex = 0;
+#else
 static uint64_t g_nextStreamIndex = 0;
+#endif
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -96,9 +104,7 @@ uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
     NS_LOG_FUNCTION_NOARGS();
-    uint64_t next = g_nextStreamIndex;
-    g_nextStreamIndex++;
-    return next;
+    return g_nextStreamIndex++;
 }
 
 void
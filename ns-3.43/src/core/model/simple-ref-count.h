@@ -15,6 +15,9 @@
 
 #include <limits>
 #include <stdint.h>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 /**
  * \file
@@ -114,8 +117,7 @@ class SimpleRefCount : public PARENT
      */
     inline void Unref() const
     {
-        m_count--;
-        if (m_count == 0)
+        if (--m_count == 0)
         {
             DELETER::Delete(static_cast<T*>(const_cast<SimpleRefCount*>(this)));
         }
@@ -138,9 +140,14 @@ class SimpleRefCount : public PARENT
      *
      * \internal
      * Note we make this mutable so that the const methods can still
-     * change it.
+     * change it. It is atomic in multithreaded builds, where an object
+     * may be shared by events running in different threads.
      */
+#ifdef NS3_MTP
+    mutable std::atomic<uint32_t> m_count;
+#else
     mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "simulation-fork.h"
+
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#ifndef __WIN32__
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationFork implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SimulationFork");
+
+SimulationFork::SimulationFork(uint32_t nRuns)
+    : m_nRuns(nRuns),
+      m_maxJobs(0),
+      m_exitStatuses(nRuns, -1)
+{
+    NS_LOG_FUNCTION(this << nRuns);
+}
+
+void
+SimulationFork::SetMaxJobs(uint32_t maxJobs)
+{
+    NS_LOG_FUNCTION(this << maxJobs);
+    m_maxJobs = maxJobs;
+}
+
+uint32_t
+SimulationFork::Run()
+{
+    NS_LOG_FUNCTION(this);
+#ifdef __WIN32__
+    NS_FATAL_ERROR("SimulationFork is not supported on Windows");
+#else
+    uint32_t maxJobs = (m_maxJobs > 0) ? m_maxJobs : std::thread::hardware_concurrency();
+    maxJobs = std::max<uint32_t>(maxJobs, 1);
+
+    // Whatever is buffered would otherwise be output by every child
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+
+    std::map<pid_t, uint32_t> running;
+    uint32_t next = 0;
+    while (next < m_nRuns || !running.empty())
+    {
+        if (next < m_nRuns && running.size() < maxJobs)
+        {
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                NS_FATAL_ERROR("Could not fork run " << next);
+            }
+            if (pid == 0)
+            {
+                return next;
+            }
+            NS_LOG_INFO("Forked run " << next << " as process " << pid);
+            running[pid] = next++;
+            continue;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0 && errno == EINTR)
+        {
+            // interrupted by a signal handler installed by the program
+            continue;
+        }
+        if (pid < 0)
+        {
+            NS_FATAL_ERROR("Could not wait for the runs");
+        }
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            continue;
+        }
+        m_exitStatuses[it->second] = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        NS_LOG_INFO("Run " << it->second << " exited with " << m_exitStatuses[it->second]);
+        running.erase(it);
+    }
+#endif
+    return CHECKPOINT;
+}
+
+int
+SimulationFork::GetExitStatus(uint32_t run) const
+{
+    NS_ASSERT(run < m_nRuns);
+    return m_exitStatuses[run];
+}
+
+uint32_t
+SimulationFork::GetNFailed() const
+{
+    uint32_t nFailed = 0;
+    for (auto status : m_exitStatuses)
+    {
+        if (status != 0)
+        {
+            nFailed++;
+        }
+    }
+    return nFailed;
+}
+
+} // namespace ns3
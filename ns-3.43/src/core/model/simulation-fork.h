@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SIMULATION_FORK_H
+#define SIMULATION_FORK_H
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationFork declaration.
+ */
+
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Checkpoint a simulation in memory and restore it in several
+ * processes, to run variants of a simulation from a common warm state.
+ *
+ * Run() forks the calling process once per variant, so that each child
+ * process starts from a copy-on-write image of the whole simulation: the
+ * pending events, the nodes and their devices and queues, and the position
+ * of every random variable stream. The calling process is the checkpoint:
+ * it never runs any event after the fork, and only returns from Run() once
+ * all the children have exited.
+ *
+ * \code
+ *   Simulator::Stop(warmUp);
+ *   Simulator::Run();
+ *
+ *   SimulationFork fork(values.size());
+ *   uint32_t run = fork.Run();
+ *   if (run == SimulationFork::CHECKPOINT)
+ *     {
+ *       Simulator::Destroy();
+ *       return fork.GetNFailed() == 0 ? 0 : 1;
+ *     }
+ *   queue->SetAttribute("MaxSize", QueueSizeValue(values[run]));
+ *   Simulator::Stop(duration);
+ *   Simulator::Run();
+ * \endcode
+ *
+ * Run() must be called from the main thread, outside of Simulator::Run(),
+ * and before Simulator::Destroy(). The simulation must not rely on wall
+ * clock time or on other threads, so this does not work with the
+ * RealtimeSimulatorImpl, nor with the distributed simulator
+ * implementations. The files opened before the fork, such as the trace
+ * files, are shared by all the children, which should therefore only open
+ * their output files after the fork.
+ *
+ * This is only supported on POSIX systems.
+ */
+class SimulationFork
+{
+  public:
+    /** Value returned by Run() in the checkpoint process. */
+    static constexpr uint32_t CHECKPOINT = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Constructor.
+     *
+     * \param [in] nRuns The number of variants to run.
+     */
+    SimulationFork(uint32_t nRuns);
+
+    /**
+     * Set the maximum number of children running at the same time.
+     *
+     * \param [in] maxJobs The maximum number of children, or 0, the default,
+     * for the number of hardware threads.
+     */
+    void SetMaxJobs(uint32_t maxJobs);
+
+    /**
+     * Fork the children and wait for them to exit.
+     *
+     * \return In the i-th child, i; in the checkpoint process, CHECKPOINT,
+     * once all the children have exited.
+     */
+    uint32_t Run();
+
+    /**
+     * \param [in] run The index of a child.
+     * \return The exit status of the child, or -1 if it did not exit
+     * normally.
+     */
+    int GetExitStatus(uint32_t run) const;
+
+    /**
+     * \return The number of children which did not exit with a zero status.
+     */
+    uint32_t GetNFailed() const;
+
+  private:
+    uint32_t m_nRuns;                //!< Number of variants.
+    uint32_t m_maxJobs;              //!< Maximum number of children running at once.
+    std::vector<int> m_exitStatuses; //!< Exit status of each child.
+};
+
+} // namespace ns3
+
+#endif /* SIMULATION_FORK_H */
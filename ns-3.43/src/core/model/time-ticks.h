@@ -0,0 +1,397 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TIME_TICKS_H
+#define TIME_TICKS_H
+
+#include "int64x64.h"
+#include "nstime.h"
+
+#include <compare>
+#include <limits>
+#include <ratio>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * \file
+ * \ingroup time
+ * ns3::Ticks declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup time
+ *
+ * \brief A number of ticks of a period fixed at compile time, for the Time
+ * arithmetic of hot loops.
+ *
+ * A Ticks is a plain 64-bit integer: unlike Time, whose conversions to and
+ * from units go through int64x64_t and a lookup of the current resolution,
+ * its conversions to other periods and to seconds are computed at compile
+ * time, and its arithmetic saturates at Max() and Min() instead of
+ * overflowing.
+ *
+ * The period must be the period of a Time::Unit, from femtoseconds to
+ * years. The conversions from and to Time are free when the period is the
+ * current Time resolution, which IsResolution() tells, and go through
+ * int64x64_t otherwise.
+ *
+ * \code
+ *   NanoTicks remain = NanoTicks(interval) - (NanoTicks(now) - NanoTicks(start));
+ *   double bytes = remain.GetSeconds() * rate.GetBitRate() / 8;
+ * \endcode
+ *
+ * \tparam Period The period of a tick, as a std::ratio of seconds.
+ */
+template <typename Period>
+class Ticks
+{
+  public:
+    /** The period of a tick, in seconds. */
+    using period = Period;
+
+    /** Construct zero ticks. */
+    constexpr Ticks()
+        : m_count(0)
+    {
+    }
+
+    /**
+     * Construct from a number of ticks.
+     *
+     * \param [in] count The number of ticks.
+     */
+    explicit constexpr Ticks(int64_t count)
+        : m_count(count)
+    {
+    }
+
+    /**
+     * Convert from ticks of another period, saturating, and rounding to the
+     * nearest tick when the other period is shorter. This is implicit when
+     * the conversion is exact.
+     *
+     * \tparam OtherPeriod The period of the other ticks.
+     * \param [in] o The other ticks.
+     */
+    template <typename OtherPeriod>
+    explicit(std::ratio_divide<OtherPeriod, Period>::den != 1) constexpr Ticks(
+        const Ticks<OtherPeriod>& o)
+        : m_count(Convert<OtherPeriod>(o.GetCount()))
+    {
+    }
+
+    /**
+     * Convert from a Time, rounding to the nearest tick.
+     *
+     * \param [in] time The time.
+     */
+    explicit Ticks(const Time& time)
+        : m_count(IsResolution() ? time.GetTimeStep() : time.To(GetUnit()).Round())
+    {
+    }
+
+    /**
+     * \return The Time of these ticks, rounded to the current resolution.
+     */
+    Time ToTime() const
+    {
+        return IsResolution() ? TimeStep(m_count) : Time::From(int64x64_t(m_count), GetUnit());
+    }
+
+    /**
+     * \return Whether the period is the current Time resolution, in which
+     * case the conversions from and to Time are exact and free.
+     */
+    static bool IsResolution()
+    {
+        return Time::GetResolution() == GetUnit();
+    }
+
+    /**
+     * Compute the ticks of a ratio of seconds, such as the transmission time
+     * of a number of bits at a bit rate, rounding to the nearest tick.
+     *
+     * This is exact integer arithmetic unless the product of \pname{num} and
+     * the number of ticks per second overflows, in which case this falls
+     * back to int64x64_t.
+     *
+     * \param [in] num The numerator, in seconds.
+     * \param [in] den The denominator.
+     * \return The ticks of \pname{num} / \pname{den} seconds.
+     */
+    static Ticks FromRatio(uint64_t num, uint64_t den)
+    {
+        static_assert(Period::num == 1, "The period must divide one second");
+        constexpr uint64_t perSecond = Period::den;
+        if (den != 0 && num <= (std::numeric_limits<uint64_t>::max() - den / 2) / perSecond)
+        {
+            uint64_t count = (num * perSecond + den / 2) / den;
+            return Ticks(count > static_cast<uint64_t>(MAX) ? MAX : static_cast<int64_t>(count));
+        }
+        return Ticks((int64x64_t(num) / int64x64_t(den) * int64x64_t(perSecond)).Round());
+    }
+
+    /** \return The largest number of ticks. */
+    static constexpr Ticks Max()
+    {
+        return Ticks(MAX);
+    }
+
+    /** \return The smallest number of ticks. */
+    static constexpr Ticks Min()
+    {
+        return Ticks(MIN);
+    }
+
+    /** \return The number of ticks. */
+    constexpr int64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    /** \return The ticks in seconds. */
+    constexpr double GetSeconds() const
+    {
+        return static_cast<double>(m_count) * Period::num / Period::den;
+    }
+
+    /**
+     * \param [in] o The other ticks.
+     * \return The comparison of the numbers of ticks.
+     */
+    constexpr auto operator<=>(const Ticks& o) const = default;
+
+    /** \return The opposite ticks, saturating. */
+    constexpr Ticks operator-() const
+    {
+        return Ticks(m_count == MIN ? MAX : -m_count);
+    }
+
+    /**
+     * \param [in] o The ticks to add.
+     * \return The saturating sum.
+     */
+    constexpr Ticks operator+(const Ticks& o) const
+    {
+        return Ticks(Add(m_count, o.m_count));
+    }
+
+    /**
+     * \param [in] o The ticks to subtract.
+     * \return The saturating difference.
+     */
+    constexpr Ticks operator-(const Ticks& o) const
+    {
+        return Ticks(Subtract(m_count, o.m_count));
+    }
+
+    /**
+     * \param [in] factor The factor.
+     * \return The saturating product.
+     */
+    constexpr Ticks operator*(int64_t factor) const
+    {
+        return Ticks(Multiply(m_count, factor));
+    }
+
+    /**
+     * \param [in] divisor The divisor.
+     * \return The quotient, truncated toward zero.
+     */
+    constexpr Ticks operator/(int64_t divisor) const
+    {
+        return Ticks((m_count == MIN && divisor == -1) ? MAX : m_count / divisor);
+    }
+
+    /**
+     * \param [in] o The divisor.
+     * \return The number of times \pname{o} fits, truncated toward zero.
+     */
+    constexpr int64_t operator/(const Ticks& o) const
+    {
+        return (m_count == MIN && o.m_count == -1) ? MAX : m_count / o.m_count;
+    }
+
+    /**
+     * \param [in] o The ticks to add.
+     * \return This, after the saturating addition.
+     */
+    constexpr Ticks& operator+=(const Ticks& o)
+    {
+        m_count = Add(m_count, o.m_count);
+        return *this;
+    }
+
+    /**
+     * \param [in] o The ticks to subtract.
+     * \return This, after the saturating subtraction.
+     */
+    constexpr Ticks& operator-=(const Ticks& o)
+    {
+        m_count = Subtract(m_count, o.m_count);
+        return *this;
+    }
+
+  private:
+    /** The largest number of ticks. */
+    static constexpr int64_t MAX = std::numeric_limits<int64_t>::max();
+    /** The smallest number of ticks. */
+    static constexpr int64_t MIN = std::numeric_limits<int64_t>::min();
+
+    /**
+     * \return The Time::Unit of the period.
+     */
+    static constexpr Time::Unit GetUnit()
+    {
+        if constexpr (std::ratio_equal_v<Period, std::femto>)
+        {
+            return Time::FS;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::pico>)
+        {
+            return Time::PS;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::nano>)
+        {
+            return Time::NS;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::micro>)
+        {
+            return Time::US;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::milli>)
+        {
+            return Time::MS;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<1>>)
+        {
+            return Time::S;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<60>>)
+        {
+            return Time::MIN;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<3600>>)
+        {
+            return Time::H;
+        }
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<86400>>)
+        {
+            return Time::D;
+        }
+        else
+        {
+            static_assert(std::ratio_equal_v<Period, std::ratio<31536000>>,
+                          "The period must be the period of a Time::Unit");
+            return Time::Y;
+        }
+    }
+
+    /**
+     * \param [in] a The first term.
+     * \param [in] b The second term.
+     * \return The saturating sum.
+     */
+    static constexpr int64_t Add(int64_t a, int64_t b)
+    {
+        if (b > 0 && a > MAX - b)
+        {
+            return MAX;
+        }
+        if (b < 0 && a < MIN - b)
+        {
+            return MIN;
+        }
+        return a + b;
+    }
+
+    /**
+     * \param [in] a The first term.
+     * \param [in] b The second term.
+     * \return The saturating difference.
+     */
+    static constexpr int64_t Subtract(int64_t a, int64_t b)
+    {
+        if (b < 0 && a > MAX + b)
+        {
+            return MAX;
+        }
+        if (b > 0 && a < MIN + b)
+        {
+            return MIN;
+        }
+        return a - b;
+    }
+
+    /**
+     * \param [in] a The first factor.
+     * \param [in] b The second factor.
+     * \return The saturating product.
+     */
+    static constexpr int64_t Multiply(int64_t a, int64_t b)
+    {
+        if (a == 0 || b == 0)
+        {
+            return 0;
+        }
+        bool negative = (a < 0) != (b < 0);
+        // Compare magnitudes as unsigned, since -MIN does not fit
+        uint64_t ua = (a < 0) ? -static_cast<uint64_t>(a) : a;
+        uint64_t ub = (b < 0) ? -static_cast<uint64_t>(b) : b;
+        uint64_t limit = negative ? static_cast<uint64_t>(MAX) + 1 : MAX;
+        if (ua > limit / ub)
+        {
+            return negative ? MIN : MAX;
+        }
+        uint64_t product = ua * ub;
+        return negative ? static_cast<int64_t>(-product) : static_cast<int64_t>(product);
+    }
+
+    /**
+     * \tparam OtherPeriod The period of the ticks to convert.
+     * \param [in] count The number of ticks to convert.
+     * \return The number of ticks of this period.
+     */
+    template <typename OtherPeriod>
+    static constexpr int64_t Convert(int64_t count)
+    {
+        using Factor = std::ratio_divide<OtherPeriod, Period>;
+        static_assert(Factor::num == 1 || Factor::den == 1,
+                      "The periods must be multiples of one another");
+        if constexpr (Factor::den == 1)
+        {
+            return Multiply(count, Factor::num);
+        }
+        else
+        {
+            // Round half away from zero, like Time
+            int64_t quotient = count / Factor::den;
+            int64_t remainder = count % Factor::den;
+            if (2 * remainder >= Factor::den)
+            {
+                quotient++;
+            }
+            else if (-2 * remainder >= Factor::den)
+            {
+                quotient--;
+            }
+            return quotient;
+        }
+    }
+
+    int64_t m_count; //!< The number of ticks.
+};
+
+/** Ticks of one nanosecond, the default Time resolution. */
+using NanoTicks = Ticks<std::nano>;
+/** Ticks of one picosecond. */
+using PicoTicks = Ticks<std::pico>;
+
+} // namespace ns3
+
+#endif /* TIME_TICKS_H */
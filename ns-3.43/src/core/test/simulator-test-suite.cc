@@ -5,13 +5,30 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/adaptive-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
+#include "ns3/pool-allocator.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/recording-scheduler.h"
+#include "ns3/simulation-fork.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <set>
+#include <thread>
+#include <vector>
 
 using namespace ns3;
 
@@ -696,6 +713,711 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the ordering of events sharing the same timestamp.
+ *
+ * Events at the same timestamp must run in scheduling order, including the
+ * ones scheduled at the current time by these events, and the events left
+ * at this timestamp must remain cancellable.
+ */
+class SimulatorSameTimestampTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SimulatorSameTimestampTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    /**
+     * Test event.
+     * \param id The event identifier.
+     */
+    void Record(uint32_t id);
+    /**
+     * Test event, scheduling another event at the same time.
+     * \param id The event identifier.
+     */
+    void RecordAndScheduleNow(uint32_t id);
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    std::vector<uint32_t> m_order;    //!< Identifiers of the events, in run order.
+    EventId m_victim;                 //!< Event cancelled by an earlier event at its time.
+};
+
+SimulatorSameTimestampTestCase::SimulatorSameTimestampTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check same-timestamp event ordering with " +
+               schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SimulatorSameTimestampTestCase::Record(uint32_t id)
+{
+    m_order.push_back(id);
+}
+
+void
+SimulatorSameTimestampTestCase::RecordAndScheduleNow(uint32_t id)
+{
+    m_order.push_back(id);
+    Simulator::ScheduleNow(&SimulatorSameTimestampTestCase::Record, this, id + 100);
+    Simulator::Cancel(m_victim);
+}
+
+void
+SimulatorSameTimestampTestCase::DoRun()
+{
+    Simulator::SetScheduler(m_schedulerFactory);
+
+    Simulator::Schedule(MicroSeconds(20), &SimulatorSameTimestampTestCase::Record, this, 5);
+    Simulator::Schedule(MicroSeconds(10), &SimulatorSameTimestampTestCase::Record, this, 1);
+    Simulator::Schedule(MicroSeconds(10),
+                        &SimulatorSameTimestampTestCase::RecordAndScheduleNow,
+                        this,
+                        2);
+    m_victim = Simulator::Schedule(MicroSeconds(10), &SimulatorSameTimestampTestCase::Record, this, 3);
+    Simulator::Schedule(MicroSeconds(10), &SimulatorSameTimestampTestCase::Record, this, 4);
+    Simulator::Stop(MicroSeconds(10));
+    Simulator::Schedule(MicroSeconds(10), &SimulatorSameTimestampTestCase::Record, this, 6);
+    Simulator::Run();
+
+    std::vector<uint32_t> expected{1, 2, 4};
+    NS_TEST_ASSERT_MSG_EQ((m_order == expected), true, "Wrong order at the same timestamp");
+    NS_TEST_ASSERT_MSG_EQ(Simulator::Now(), MicroSeconds(10), "Wrong stop time");
+
+    // The events after the Stop event, including the one scheduled at the
+    // same time, are left for the next run
+    m_order.clear();
+    Simulator::Run();
+    expected = {6, 102, 5};
+    NS_TEST_ASSERT_MSG_EQ((m_order == expected), true, "Wrong order after the stop");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that pooled events keep their arguments alive as long as
+ * needed, whether they are invoked, cancelled or destroyed.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+    void DoRun() override;
+
+  private:
+    /** Reference counted event target. */
+    class Target : public SimpleRefCount<Target>
+    {
+      public:
+        /** Count an invocation. */
+        void Hit()
+        {
+            m_hits++;
+        }
+
+        uint32_t m_hits{0}; //!< Number of invocations.
+    };
+
+    /**
+     * Function event.
+     * \param target The event target.
+     */
+    static void Hit(Ptr<Target> target);
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check the lifetime of pooled events")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Hit(Ptr<Target> target)
+{
+    target->Hit();
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    Ptr<Target> target = Create<Target>();
+
+    // A released event is recycled for the next event of the same size
+    EventImpl* first = MakeEvent(&SimulatorEventPoolTestCase::Hit, target);
+    void* address = first;
+    first->Unref();
+    EventImpl* second = MakeEvent(&SimulatorEventPoolTestCase::Hit, target);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<void*>(second), address, "Event memory not recycled");
+    second->Invoke();
+    second->Unref();
+    NS_TEST_ASSERT_MSG_EQ(target->m_hits, 1, "Recycled event not invoked");
+    NS_TEST_ASSERT_MSG_EQ(target->GetReferenceCount(), 1, "Event arguments leaked");
+
+    target->m_hits = 0;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        EventId a = Simulator::Schedule(MicroSeconds(i), &Target::Hit, target);
+        EventId b = Simulator::Schedule(MicroSeconds(i), &SimulatorEventPoolTestCase::Hit, target);
+        Simulator::Schedule(MicroSeconds(i), [target]() { target->Hit(); });
+        if (i % 2 == 0)
+        {
+            a.Cancel();
+        }
+        if (i % 5 == 0)
+        {
+            Simulator::Remove(b);
+        }
+        // Never run, released by Simulator::Destroy
+        Simulator::Schedule(Seconds(10), &Target::Hit, target);
+    }
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(target->m_hits, 50 + 80 + 100, "Wrong number of invoked events");
+    Simulator::Destroy();
+    NS_TEST_ASSERT_MSG_EQ(target->GetReferenceCount(), 1, "Event arguments leaked");
+
+    // Each thread recycles the events from its own pools
+    uint64_t hits = PoolAllocator::GetStats().hits;
+    bool recycled = false;
+    PoolAllocator::Stats threadStats;
+    std::thread thread([&]() {
+        EventImpl* event = MakeEvent(&SimulatorEventPoolTestCase::Hit, target);
+        void* freed = event;
+        event->Unref();
+        event = MakeEvent(&SimulatorEventPoolTestCase::Hit, target);
+        recycled = (event == freed);
+        event->Unref();
+        threadStats = PoolAllocator::GetStats();
+    });
+    thread.join();
+    NS_TEST_ASSERT_MSG_EQ(recycled, true, "Event memory not recycled by the thread");
+    NS_TEST_ASSERT_MSG_EQ(threadStats.hits, 1, "Wrong hits in the thread");
+    NS_TEST_ASSERT_MSG_EQ(threadStats.misses, 1, "Wrong misses in the thread");
+    NS_TEST_ASSERT_MSG_EQ(PoolAllocator::GetStats().hits, hits, "Thread used the main pools");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the ordering of a scheduler holding many pending events.
+ *
+ * Events are inserted, removed and cancelled at random, with clustered and
+ * widely spread timestamps, and the scheduler output is compared with a
+ * std::set of the pending event keys.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check event ordering with " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    std::set<Scheduler::EventKey> reference;
+    std::mt19937_64 rng(1);
+    uint32_t uid = 0;
+    uint64_t now = 0;
+
+    auto insert = [&](uint64_t ts) {
+        Scheduler::Event ev;
+        ev.impl = nullptr;
+        ev.key.m_ts = ts;
+        ev.key.m_uid = uid++;
+        ev.key.m_context = 0;
+        scheduler->Insert(ev);
+        reference.insert(ev.key);
+    };
+    auto removeNext = [&]() {
+        Scheduler::Event ev = scheduler->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ((ev.key == *reference.begin()), true, "Wrong event order");
+        reference.erase(reference.begin());
+        now = ev.key.m_ts;
+    };
+
+    for (uint32_t step = 0; step < 200000; step++)
+    {
+        uint32_t op = rng() % 8;
+        if (op < 5 || reference.empty())
+        {
+            // Mostly short delays, some same-time events, a few far away
+            uint64_t delay = rng() % 4 == 0 ? 0 : rng() % 1000;
+            if (rng() % 100 == 0)
+            {
+                delay = rng() % 100000000;
+            }
+            insert(now + delay);
+        }
+        else if (op < 7)
+        {
+            removeNext();
+        }
+        else
+        {
+            // Cancel a random pending event
+            auto it = reference.lower_bound(Scheduler::EventKey{now + rng() % 2000, 0, 0});
+            if (it == reference.end())
+            {
+                it = reference.begin();
+            }
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key = *it;
+            scheduler->Remove(ev);
+            reference.erase(it);
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), reference.empty(), "Wrong scheduler size");
+        if (!reference.empty())
+        {
+            NS_TEST_ASSERT_MSG_EQ((scheduler->PeekNext().key == *reference.begin()),
+                                  true,
+                                  "Wrong next event");
+        }
+    }
+    while (!reference.empty())
+    {
+        removeNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "Scheduler not empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the event profiler accounts the events to the functions
+ * they call and to their contexts.
+ */
+class SimulatorProfileTestCase : public TestCase
+{
+  public:
+    SimulatorProfileTestCase();
+    void DoRun() override;
+
+    /** Event target with a virtual function. */
+    class Base
+    {
+      public:
+        virtual ~Base() = default;
+        /** Event function, overridden. */
+        virtual void Work();
+    };
+
+    /** Event target overriding the virtual function. */
+    class Derived : public Base
+    {
+      public:
+        void Work() override;
+    };
+
+    /** Event target destroyed by its virtual function. */
+    class Transient : public Base
+    {
+      public:
+        void Work() override;
+    };
+
+    /** Event function. */
+    void Count();
+
+  private:
+    /**
+     * \param [in] filename The name of a file.
+     * \return The content of the file.
+     */
+    static std::string ReadFile(const std::string& filename);
+
+    /**
+     * \param [in] flat A flat profile.
+     * \param [in] name The name of a row.
+     * \return The number of events of the row.
+     */
+    static uint64_t GetCount(const std::string& flat, const std::string& name);
+
+    uint32_t m_count; //!< Number of events run.
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase()
+    : TestCase("Check the event profile"),
+      m_count(0)
+{
+}
+
+void
+SimulatorProfileTestCase::Base::Work()
+{
+}
+
+void
+SimulatorProfileTestCase::Derived::Work()
+{
+}
+
+void
+SimulatorProfileTestCase::Transient::Work()
+{
+    delete this;
+}
+
+void
+SimulatorProfileTestCase::Count()
+{
+    m_count++;
+}
+
+std::string
+SimulatorProfileTestCase::ReadFile(const std::string& filename)
+{
+    std::ifstream is(filename);
+    std::ostringstream oss;
+    oss << is.rdbuf();
+    return oss.str();
+}
+
+uint64_t
+SimulatorProfileTestCase::GetCount(const std::string& flat, const std::string& name)
+{
+    std::istringstream is(flat);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.size() > name.size() && line.ends_with("  " + name))
+        {
+            double percent;
+            double seconds;
+            uint64_t count = 0;
+            std::istringstream(line) >> percent >> seconds >> count;
+            return count;
+        }
+    }
+    return 0;
+}
+
+void
+SimulatorProfileTestCase::DoRun()
+{
+    std::string prefix = CreateTempDirFilename("profile");
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(prefix));
+
+    Derived derived;
+    Base* base = &derived;
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorProfileTestCase::Count, this);
+        Simulator::ScheduleWithContext(3, MicroSeconds(i), &SimulatorProfileTestCase::Count, this);
+        Simulator::Schedule(MicroSeconds(i), &Base::Work, base);
+        Simulator::Schedule(MicroSeconds(i), &Base::Work, static_cast<Base*>(new Transient));
+        Simulator::Schedule(MicroSeconds(i), [this]() { Count(); });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(""));
+    NS_TEST_ASSERT_MSG_EQ(m_count, 30, "Wrong number of events");
+
+    std::string flat = ReadFile(prefix + ".txt");
+    NS_TEST_EXPECT_MSG_EQ(GetCount(flat, "SimulatorProfileTestCase::Count()"),
+                          20,
+                          "Member function not profiled:\n"
+                              << flat);
+    NS_TEST_EXPECT_MSG_EQ(GetCount(flat, "SimulatorProfileTestCase::Derived::Work()"),
+                          10,
+                          "Virtual function not resolved:\n"
+                              << flat);
+    NS_TEST_EXPECT_MSG_EQ(GetCount(flat, "SimulatorProfileTestCase::Transient::Work()"),
+                          10,
+                          "Virtual function of a destroyed object not resolved:\n"
+                              << flat);
+    NS_TEST_EXPECT_MSG_EQ(GetCount(flat, "node 3"), 10, "Context not profiled:\n" << flat);
+    NS_TEST_EXPECT_MSG_EQ(GetCount(flat, "no context"), 40, "Context not profiled:\n" << flat);
+
+    std::string folded = ReadFile(prefix + ".folded");
+    NS_TEST_EXPECT_MSG_NE(folded.find("node 3;SimulatorProfileTestCase::Count() "),
+                          std::string::npos,
+                          "Stack not folded:\n"
+                              << folded);
+    NS_TEST_EXPECT_MSG_NE(folded.find("no context;SimulatorProfileTestCase::Count() "),
+                          std::string::npos,
+                          "Stack not folded:\n"
+                              << folded);
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the runs forked by SimulationFork resume from the
+ * state of the simulation at the fork, independently of each other.
+ */
+class SimulationForkTestCase : public TestCase
+{
+  public:
+    SimulationForkTestCase();
+    void DoRun() override;
+
+  private:
+    /** Count an event. */
+    void Count();
+
+    uint32_t m_count; //!< Number of events run.
+};
+
+SimulationForkTestCase::SimulationForkTestCase()
+    : TestCase("Check the runs forked from a checkpoint"),
+      m_count(0)
+{
+}
+
+void
+SimulationForkTestCase::Count()
+{
+    m_count++;
+}
+
+void
+SimulationForkTestCase::DoRun()
+{
+    for (uint32_t i = 1; i < 10; i++)
+    {
+        Simulator::Schedule(MilliSeconds(100 * i), &SimulationForkTestCase::Count, this);
+    }
+    Simulator::Schedule(MilliSeconds(1500), &SimulationForkTestCase::Count, this);
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    SimulationFork fork(3);
+    fork.SetMaxJobs(2);
+    uint32_t run = fork.Run();
+    if (run != SimulationFork::CHECKPOINT)
+    {
+        // In a child: report the state in the file of the run, and the
+        // success through the exit status
+        bool ok = Simulator::Now() == Seconds(1) && m_count == 9;
+        for (uint32_t i = 0; i < run; i++)
+        {
+            Simulator::Schedule(MilliSeconds(i), &SimulationForkTestCase::Count, this);
+        }
+        Simulator::Run();
+        ok = ok && Simulator::Now() == MilliSeconds(1500);
+        std::ofstream(CreateTempDirFilename("fork-run-" + std::to_string(run))) << m_count;
+        std::_Exit(ok ? 0 : 1);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(fork.GetNFailed(), 0, "Wrong number of failed runs");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(fork.GetExitStatus(i), 0, "Run " << i << " failed");
+        uint32_t count = 0;
+        std::ifstream(CreateTempDirFilename("fork-run-" + std::to_string(i))) >> count;
+        NS_TEST_ASSERT_MSG_EQ(count, 10 + i, "Wrong state in run " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(Simulator::Now(), Seconds(1), "Checkpoint time changed");
+    NS_TEST_ASSERT_MSG_EQ(m_count, 9, "Checkpoint state changed");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the AdaptiveScheduler migrates its events to the
+ * backend suited to each phase of a run, without reordering them.
+ */
+class AdaptiveSchedulerTestCase : public TestCase
+{
+  public:
+    AdaptiveSchedulerTestCase();
+    void DoRun() override;
+};
+
+AdaptiveSchedulerTestCase::AdaptiveSchedulerTestCase()
+    : TestCase("Check the backend migrations of the AdaptiveScheduler")
+{
+}
+
+void
+AdaptiveSchedulerTestCase::DoRun()
+{
+    // Only look at the event population, not at the wall-clock cost
+    Ptr<AdaptiveScheduler> scheduler = CreateObjectWithAttributes<AdaptiveScheduler>(
+        "Window", UintegerValue(1000), "Hysteresis", UintegerValue(1), "LadderSize",
+        UintegerValue(1000), "CostTolerance", DoubleValue(1e9));
+    std::set<Scheduler::EventKey> reference;
+    std::mt19937_64 rng(1);
+    uint32_t uid = 0;
+    uint64_t now = 0;
+
+    auto insert = [&](uint64_t delay) {
+        Scheduler::Event ev;
+        ev.impl = nullptr;
+        ev.key = Scheduler::EventKey{now + delay, uid++, 0};
+        scheduler->Insert(ev);
+        reference.insert(ev.key);
+    };
+    auto removeNext = [&]() {
+        Scheduler::Event ev = scheduler->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ((ev.key == *reference.begin()), true, "Wrong event order");
+        reference.erase(reference.begin());
+        now = ev.key.m_ts;
+    };
+    auto cancel = [&]() {
+        auto it = reference.lower_bound(Scheduler::EventKey{now + rng() % 1000, 0, 0});
+        if (it == reference.end())
+        {
+            it = reference.begin();
+        }
+        Scheduler::Event ev;
+        ev.impl = nullptr;
+        ev.key = *it;
+        scheduler->Remove(ev);
+        reference.erase(it);
+    };
+
+    // A handful of events
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        insert(rng() % 1000);
+    }
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        insert(rng() % 1000);
+        removeNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->GetBackend(),
+                          PriorityQueueScheduler::GetTypeId(),
+                          "Wrong backend");
+
+    // Many events
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        insert(rng() % 1000);
+    }
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        insert(rng() % 1000);
+        removeNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->GetBackend(), LadderScheduler::GetTypeId(), "Wrong backend");
+
+    // Many cancelled events
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        insert(rng() % 1000);
+        if (rng() % 10 < 3)
+        {
+            cancel();
+        }
+        else
+        {
+            removeNext();
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->GetBackend(), MapScheduler::GetTypeId(), "Wrong backend");
+
+    // A handful of events again
+    while (reference.size() > 10)
+    {
+        removeNext();
+    }
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        insert(rng() % 1000);
+        removeNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->GetBackend(),
+                          PriorityQueueScheduler::GetTypeId(),
+                          "Wrong backend");
+    NS_TEST_ASSERT_MSG_EQ(scheduler->GetNMigrations(), 3, "Wrong number of migrations");
+
+    while (!reference.empty())
+    {
+        removeNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "Scheduler not empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the RecordingScheduler records the scheduler
+ * operations of a run.
+ */
+class RecordingSchedulerTestCase : public TestCase
+{
+  public:
+    RecordingSchedulerTestCase();
+    void DoRun() override;
+
+  private:
+    /** Event function. */
+    void Noop();
+};
+
+RecordingSchedulerTestCase::RecordingSchedulerTestCase()
+    : TestCase("Check the trace of the RecordingScheduler")
+{
+}
+
+void
+RecordingSchedulerTestCase::Noop()
+{
+}
+
+void
+RecordingSchedulerTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("scheduler.trace");
+    ObjectFactory factory;
+    factory.SetTypeId(RecordingScheduler::GetTypeId());
+    factory.Set("FileName", StringValue(fileName));
+    Simulator::SetScheduler(factory);
+
+    Simulator::Schedule(MicroSeconds(1), &RecordingSchedulerTestCase::Noop, this);
+    EventId removed = Simulator::Schedule(MicroSeconds(2), &RecordingSchedulerTestCase::Noop, this);
+    Simulator::Schedule(MicroSeconds(3), &RecordingSchedulerTestCase::Noop, this);
+    Simulator::Remove(removed);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::vector<std::pair<char, Time>> expected = {{'i', MicroSeconds(1)},
+                                                   {'i', MicroSeconds(2)},
+                                                   {'i', MicroSeconds(3)},
+                                                   {'c', MicroSeconds(2)},
+                                                   {'r', MicroSeconds(1)},
+                                                   {'r', MicroSeconds(3)}};
+    std::ifstream is(fileName);
+    char op;
+    uint64_t ts;
+    uint32_t uid;
+    for (const auto& [expectedOp, expectedTime] : expected)
+    {
+        NS_TEST_ASSERT_MSG_EQ(bool(is >> op >> ts >> uid), true, "Missing operation");
+        NS_TEST_EXPECT_MSG_EQ(op, expectedOp, "Wrong operation");
+        NS_TEST_EXPECT_MSG_EQ(ts,
+                              static_cast<uint64_t>(expectedTime.GetTimeStep()),
+                              "Wrong timestamp");
+    }
+    NS_TEST_EXPECT_MSG_EQ(bool(is >> op), false, "Extra operation");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -719,6 +1441,31 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(CalendarScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorEventPoolTestCase(), TestCase::Duration::QUICK);
+        factory.SetTypeId(MapScheduler::GetTypeId());
+        AddTestCase(new SimulatorSameTimestampTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorSameTimestampTestCase(factory), TestCase::Duration::QUICK);
+        // Small windows, and about as many cancelled events as the
+        // threshold, to migrate often
+        ObjectFactory adaptive;
+        adaptive.SetTypeId(AdaptiveScheduler::GetTypeId());
+        adaptive.Set("Window", UintegerValue(256));
+        adaptive.Set("Hysteresis", UintegerValue(1));
+        adaptive.Set("CancelFraction", DoubleValue(0.2));
+        AddTestCase(new SimulatorEventsTestCase(adaptive), TestCase::Duration::QUICK);
+        AddTestCase(new SchedulerOrderTestCase(adaptive), TestCase::Duration::QUICK);
+        AddTestCase(new AdaptiveSchedulerTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new RecordingSchedulerTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorProfileTestCase(), TestCase::Duration::QUICK);
+#ifndef __WIN32__
+        AddTestCase(new SimulationForkTestCase(), TestCase::Duration::QUICK);
+#endif
     }
 };
 
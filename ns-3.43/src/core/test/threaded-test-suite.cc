@@ -14,11 +14,13 @@
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <atomic>
 #include <chrono> // seconds, milliseconds
 #include <ctime>
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -267,6 +269,129 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that the events scheduled by other threads are all run, in
+ * the order each thread scheduled them.
+ */
+class ThreadedScheduleWithContextTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param simulatorType The simulator implementation type.
+     * \param threads The number of threads.
+     */
+    ThreadedScheduleWithContextTestCase(const std::string& simulatorType, unsigned int threads);
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Record an event scheduled by a thread.
+     * \param threadno The thread number.
+     * \param seq The sequence number of the event in the thread.
+     */
+    void Record(unsigned int threadno, uint32_t seq);
+    /** Stop the simulation once all the events have been run. */
+    void Poll();
+
+    /** Number of events scheduled by each thread. */
+    static constexpr uint32_t N_EVENTS = 20000;
+
+    std::string m_simulatorType;               //!< The simulator implementation type.
+    unsigned int m_threads;                    //!< The number of threads.
+    std::vector<std::vector<uint32_t>> m_seqs; //!< Sequence numbers received from each thread.
+    uint64_t m_received;                       //!< Number of events run.
+    std::atomic<unsigned int> m_done;          //!< Number of threads done scheduling.
+};
+
+ThreadedScheduleWithContextTestCase::ThreadedScheduleWithContextTestCase(
+    const std::string& simulatorType,
+    unsigned int threads)
+    : TestCase("Check the order of the events scheduled by " + std::to_string(threads) +
+               " threads with " + simulatorType),
+      m_simulatorType(simulatorType),
+      m_threads(threads),
+      m_received(0),
+      m_done(0)
+{
+}
+
+void
+ThreadedScheduleWithContextTestCase::Record(unsigned int threadno, uint32_t seq)
+{
+    NS_ASSERT(Simulator::GetContext() == threadno);
+    m_seqs[threadno].push_back(seq);
+    m_received++;
+}
+
+void
+ThreadedScheduleWithContextTestCase::Poll()
+{
+    if (m_done == m_threads && m_received == uint64_t(m_threads) * N_EVENTS)
+    {
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(MicroSeconds(1), &ThreadedScheduleWithContextTestCase::Poll, this);
+}
+
+void
+ThreadedScheduleWithContextTestCase::DoSetup()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(m_simulatorType));
+}
+
+void
+ThreadedScheduleWithContextTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+void
+ThreadedScheduleWithContextTestCase::DoRun()
+{
+    m_seqs.assign(m_threads, {});
+    Simulator::Schedule(MicroSeconds(1), &ThreadedScheduleWithContextTestCase::Poll, this);
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < m_threads; i++)
+    {
+        threads.emplace_back([this, i]() {
+            for (uint32_t seq = 0; seq < N_EVENTS; seq++)
+            {
+                Simulator::ScheduleWithContext(i,
+                                               Time(0),
+                                               &ThreadedScheduleWithContextTestCase::Record,
+                                               this,
+                                               i,
+                                               seq);
+            }
+            m_done++;
+        });
+    }
+    Simulator::Run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    Simulator::Destroy();
+
+    for (unsigned int i = 0; i < m_threads; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_seqs[i].size(), N_EVENTS, "Events of thread " << i << " lost");
+        for (uint32_t seq = 0; seq < N_EVENTS; seq++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(m_seqs[i][seq], seq, "Events of thread " << i << " reordered");
+        }
+    }
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -287,6 +412,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
             "ns3::HeapScheduler",
             "ns3::MapScheduler",
             "ns3::CalendarScheduler",
+            "ns3::LadderScheduler",
         };
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
@@ -304,6 +430,14 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+        for (auto& simulatorType : simulatorTypes)
+        {
+            for (unsigned int threadCount : {1, 8})
+            {
+                AddTestCase(new ThreadedScheduleWithContextTestCase(simulatorType, threadCount),
+                            TestCase::Duration::QUICK);
+            }
+        }
     }
 };
 
@@ -11,6 +11,7 @@
 #include "ns3/int64x64.h"
 #include "ns3/nstime.h"
 #include "ns3/test.h"
+#include "ns3/time-ticks.h"
 
 #include <array>
 #include <iomanip>
@@ -523,6 +524,81 @@ TimeInputOutputTestCase::DoRun()
     CheckAs(t * 1e+8, "+9.961925y");
 }
 
+/**
+ * \ingroup core-tests
+ * \brief Test the conversions and the saturating arithmetic of Ticks.
+ */
+class TimeTicksTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor for TimeTicksTestCase.
+     */
+    TimeTicksTestCase();
+
+  private:
+    /**
+     * \brief DoRun for TimeTicksTestCase.
+     */
+    void DoRun() override;
+};
+
+TimeTicksTestCase::TimeTicksTestCase()
+    : TestCase("Ticks conversions and saturating arithmetic")
+{
+}
+
+void
+TimeTicksTestCase::DoRun()
+{
+    using MicroTicks = Ticks<std::micro>;
+
+    // Compile-time conversions and arithmetic
+    static_assert(NanoTicks(MicroTicks(3)).GetCount() == 3000);
+    static_assert(MicroTicks(NanoTicks(1499)).GetCount() == 1);
+    static_assert(MicroTicks(NanoTicks(1500)).GetCount() == 2);
+    static_assert(MicroTicks(NanoTicks(-1500)).GetCount() == -2);
+    static_assert(NanoTicks(MicroTicks::Max()) == NanoTicks::Max());
+    static_assert(NanoTicks(MicroTicks::Min()) == NanoTicks::Min());
+    static_assert(NanoTicks(1500000000).GetSeconds() == 1.5);
+    static_assert(NanoTicks(7) / NanoTicks(2) == 3);
+
+    NS_TEST_ASSERT_MSG_EQ((NanoTicks::Max() + NanoTicks(1) == NanoTicks::Max()),
+                          true,
+                          "Addition does not saturate");
+    NS_TEST_ASSERT_MSG_EQ((NanoTicks::Min() - NanoTicks(1) == NanoTicks::Min()),
+                          true,
+                          "Subtraction does not saturate");
+    NS_TEST_ASSERT_MSG_EQ((NanoTicks::Max() * 2 == NanoTicks::Max()),
+                          true,
+                          "Multiplication does not saturate");
+    NS_TEST_ASSERT_MSG_EQ((NanoTicks::Max() * -2 == NanoTicks::Min()),
+                          true,
+                          "Multiplication does not saturate");
+    NS_TEST_ASSERT_MSG_EQ((-NanoTicks::Min() == NanoTicks::Max()),
+                          true,
+                          "Negation does not saturate");
+    NS_TEST_ASSERT_MSG_EQ((NanoTicks(-4) * -3).GetCount(), 12, "Wrong product");
+
+    // Conversions from and to Time, at the default nanosecond resolution
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks::IsResolution(), true, "Nanoseconds are the resolution");
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks(Seconds(1.5)).GetCount(), 1500000000, "Wrong ticks");
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks(-17).ToTime(), NanoSeconds(-17), "Wrong time");
+    NS_TEST_ASSERT_MSG_EQ(PicoTicks::IsResolution(), false, "Picoseconds are not the resolution");
+    NS_TEST_ASSERT_MSG_EQ(PicoTicks(NanoSeconds(3)).GetCount(), 3000, "Wrong ticks");
+    NS_TEST_ASSERT_MSG_EQ(PicoTicks(1499).ToTime(), NanoSeconds(1), "Wrong rounding");
+    NS_TEST_ASSERT_MSG_EQ(PicoTicks(1500).ToTime(), NanoSeconds(2), "Wrong rounding");
+    NS_TEST_ASSERT_MSG_EQ(MicroTicks(NanoSeconds(2500)).GetCount(), 3, "Wrong rounding");
+
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks::FromRatio(12000, 1000000000).GetCount(), 12000, "Wrong ratio");
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks::FromRatio(1, 3).GetCount(), 333333333, "Wrong rounding");
+    NS_TEST_ASSERT_MSG_EQ(NanoTicks::FromRatio(2, 3).GetCount(), 666666667, "Wrong rounding");
+    // 10^8 * 10^12 overflows, and falls back to int64x64_t
+    NS_TEST_ASSERT_MSG_EQ(PicoTicks::FromRatio(100000000, 1000).GetCount(),
+                          100000000000000000,
+                          "Wrong ratio");
+}
+
 /**
  * \ingroup core-tests
  * \brief   Time test Suite.  Runs the appropriate test cases for time
@@ -535,6 +611,7 @@ static class TimeTestSuite : public TestSuite
     {
         AddTestCase(new TimeWithSignTestCase(), TestCase::Duration::QUICK);
         AddTestCase(new TimeInputOutputTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new TimeTicksTestCase(), TestCase::Duration::QUICK);
         // This should be last, since it changes the resolution
         AddTestCase(new TimeSimpleTestCase(), TestCase::Duration::QUICK);
     }
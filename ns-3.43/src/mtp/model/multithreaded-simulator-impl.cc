@@ -0,0 +1,670 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/make-event.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <barrier>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess* MultithreadedSimulatorImpl::g_currentLp =
+    nullptr;
+
+/** Marker of an empty event queue or of an unbounded window. */
+static constexpr uint64_t NO_TIMESTAMP = std::numeric_limits<uint64_t>::max();
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of threads running the logical processes, "
+                          "0 for the number of hardware threads",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_partitioned(false),
+      m_lookahead(NO_TIMESTAMP),
+      m_maxThreads(0),
+      m_stop(false),
+      m_stopTs(NO_TIMESTAMP),
+      m_parallel(false),
+      m_windowEnd(0),
+      m_nextLp(0),
+      m_mainThreadId(std::this_thread::get_id())
+{
+    NS_LOG_FUNCTION(this);
+    m_lps.push_back(std::make_unique<LogicalProcess>());
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& lp : m_lps)
+    {
+        while (lp->events && !lp->events->IsEmpty())
+        {
+            Scheduler::Event next = lp->events->RemoveNext();
+            next.impl->Unref();
+        }
+        for (auto& outbox : lp->outbox)
+        {
+            for (auto& ev : outbox)
+            {
+                ev.impl->Unref();
+            }
+            outbox.clear();
+        }
+        lp->events = nullptr;
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (auto& lp : m_lps)
+    {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        while (lp->events && !lp->events->IsEmpty())
+        {
+            scheduler->Insert(lp->events->RemoveNext());
+        }
+        lp->events = scheduler;
+    }
+}
+
+MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetLogicalProcess(uint32_t context) const
+{
+    if (context < m_nodeLps.size())
+    {
+        return *m_lps[m_nodeLps[context]];
+    }
+    return *m_lps[0];
+}
+
+MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetCurrentLogicalProcess() const
+{
+    return g_currentLp != nullptr ? *g_currentLp : *m_lps[0];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert(LogicalProcess& lp, Scheduler::Event ev)
+{
+    ev.key.m_uid = lp.uid;
+    lp.uid++;
+    lp.events->Insert(ev);
+    return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Union-find of the nodes which must share a logical process
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t n) {
+        while (parent[n] != n)
+        {
+            parent[n] = parent[parent[n]];
+            n = parent[n];
+        }
+        return n;
+    };
+
+    // Only the channels which just deliver a copy of the packet to the other
+    // nodes after a fixed delay can separate logical processes
+    std::vector<TypeId> delayLines;
+    for (const auto& name : {"ns3::PointToPointChannel", "ns3::SimpleChannel"})
+    {
+        TypeId tid;
+        if (TypeId::LookupByNameFailSafe(name, &tid))
+        {
+            delayLines.push_back(tid);
+        }
+    }
+
+    uint64_t lookahead = NO_TIMESTAMP;
+    for (auto node = NodeList::Begin(); node != NodeList::End(); node++)
+    {
+        for (uint32_t i = 0; i < (*node)->GetNDevices(); i++)
+        {
+            Ptr<Channel> channel = (*node)->GetDevice(i)->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            TypeId tid = channel->GetInstanceTypeId();
+            bool isDelayLine = std::any_of(delayLines.begin(),
+                                           delayLines.end(),
+                                           [&tid](TypeId t) { return tid == t || tid.IsChildOf(t); });
+            TimeValue delay;
+            if (isDelayLine && channel->GetAttributeFailSafe("Delay", delay) &&
+                delay.Get().IsStrictlyPositive())
+            {
+                lookahead = std::min<uint64_t>(lookahead, delay.Get().GetTimeStep());
+                continue;
+            }
+            for (std::size_t j = 0; j < channel->GetNDevices(); j++)
+            {
+                Ptr<NetDevice> device = channel->GetDevice(j);
+                if (device && device->GetNode())
+                {
+                    parent[find(device->GetNode()->GetId())] = find((*node)->GetId());
+                }
+            }
+        }
+    }
+
+    m_nodeLps.resize(nNodes);
+    std::vector<uint32_t> rootLps(nNodes, 0);
+    for (uint32_t n = 0; n < nNodes; n++)
+    {
+        uint32_t root = find(n);
+        if (rootLps[root] == 0)
+        {
+            rootLps[root] = m_lps.size();
+            auto lp = std::make_unique<LogicalProcess>();
+            lp->id = m_lps.size();
+            lp->events = m_schedulerFactory.Create<Scheduler>();
+            m_lps.push_back(std::move(lp));
+        }
+        m_nodeLps[n] = rootLps[root];
+    }
+    m_lookahead = lookahead;
+
+    // Move the events scheduled so far to their logical process; the uids
+    // of the new events must not collide with the ones of the moved events
+    LogicalProcess& pub = *m_lps[0];
+    std::vector<Scheduler::Event> publicEvents;
+    while (!pub.events->IsEmpty())
+    {
+        Scheduler::Event ev = pub.events->RemoveNext();
+        LogicalProcess& lp = GetLogicalProcess(ev.key.m_context);
+        if (&lp == &pub)
+        {
+            publicEvents.push_back(ev);
+        }
+        else
+        {
+            lp.events->Insert(ev);
+        }
+    }
+    for (const auto& ev : publicEvents)
+    {
+        pub.events->Insert(ev);
+    }
+    for (auto& lp : m_lps)
+    {
+        lp->uid = pub.uid;
+        lp->currentTs = pub.currentTs;
+        lp->outbox.resize(m_lps.size());
+    }
+
+    NS_LOG_INFO("Partitioned " << nNodes << " nodes into " << m_lps.size() - 1
+                               << " logical processes, lookahead " << GetLookahead());
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    m_mainThreadId = std::this_thread::get_id();
+    if (!m_partitioned)
+    {
+        Partition();
+        m_partitioned = true;
+    }
+    m_stop = false;
+    m_stopTs = NO_TIMESTAMP;
+
+    auto nLps = static_cast<uint32_t>(m_lps.size());
+    uint32_t nThreads = (m_maxThreads > 0) ? m_maxThreads : std::thread::hardware_concurrency();
+    nThreads = std::clamp<uint32_t>(nThreads, 1, std::max<uint32_t>(nLps - 1, 1));
+
+    // The completion of the barrier runs on a single thread while the others
+    // wait, so it is where the serial part of the simulation happens
+    bool running = false;
+    auto synchronize = [this, &running]() noexcept { running = Synchronize(); };
+    std::barrier barrier(nThreads, synchronize);
+    auto worker = [this, &barrier, &running, nLps]() {
+        while (true)
+        {
+            barrier.arrive_and_wait();
+            if (!running)
+            {
+                break;
+            }
+            for (uint32_t i = m_nextLp++; i < nLps; i = m_nextLp++)
+            {
+                ProcessWindow(*m_lps[i]);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Outside of Run(), the time is the one of the latest event
+    LogicalProcess& pub = *m_lps[0];
+    for (const auto& lp : m_lps)
+    {
+        pub.currentTs = std::max(pub.currentTs, lp->currentTs);
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::Synchronize()
+{
+    m_parallel = false;
+
+    // Deliver the outboxes in a deterministic order
+    for (auto& src : m_lps)
+    {
+        for (uint32_t dst = 0; dst < src->outbox.size(); dst++)
+        {
+            for (const auto& ev : src->outbox[dst])
+            {
+                Insert(*m_lps[dst], ev);
+            }
+            src->outbox[dst].clear();
+        }
+    }
+
+    LogicalProcess& pub = *m_lps[0];
+    while (!m_stop)
+    {
+        uint64_t nodesNext = NO_TIMESTAMP;
+        for (uint32_t i = 1; i < m_lps.size(); i++)
+        {
+            if (!m_lps[i]->events->IsEmpty())
+            {
+                nodesNext = std::min(nodesNext, m_lps[i]->events->PeekNext().key.m_ts);
+            }
+        }
+        uint64_t publicNext = pub.events->IsEmpty() ? NO_TIMESTAMP : pub.events->PeekNext().key.m_ts;
+        if (nodesNext == NO_TIMESTAMP && publicNext == NO_TIMESTAMP)
+        {
+            return false;
+        }
+
+        if (publicNext <= nodesNext)
+        {
+            // Every logical process is before publicNext: run the public
+            // events at that time alone
+            g_currentLp = &pub;
+            do
+            {
+                ProcessOneEvent(pub, pub.events->RemoveNext());
+            } while (!m_stop && !pub.events->IsEmpty() &&
+                     pub.events->PeekNext().key.m_ts == publicNext);
+            g_currentLp = nullptr;
+            continue;
+        }
+
+        m_windowEnd = (nodesNext > NO_TIMESTAMP - m_lookahead) ? NO_TIMESTAMP
+                                                                : nodesNext + m_lookahead;
+        m_windowEnd = std::min(m_windowEnd, publicNext);
+        m_nextLp = 1;
+        m_parallel = true;
+        return true;
+    }
+    return false;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(LogicalProcess& lp)
+{
+    g_currentLp = &lp;
+    while (!lp.events->IsEmpty())
+    {
+        uint64_t ts = lp.events->PeekNext().key.m_ts;
+        if (ts >= m_windowEnd || ts > m_stopTs.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+        ProcessOneEvent(lp, lp.events->RemoveNext());
+    }
+    g_currentLp = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(LogicalProcess& lp, const Scheduler::Event& next)
+{
+    NS_ASSERT(next.key.m_ts >= lp.currentTs);
+    lp.eventCount++;
+    lp.currentTs = next.key.m_ts;
+    lp.currentContext = next.key.m_context;
+    lp.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    return std::all_of(m_lps.begin(), m_lps.end(), [](const auto& lp) {
+        return lp->events->IsEmpty();
+    });
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_parallel)
+    {
+        StopAt(GetCurrentLogicalProcess().currentTs);
+        return;
+    }
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Stop(): Negative delay");
+
+    // The stop event runs in the public logical process, which bounds the
+    // windows, so that no logical process runs past it
+    LogicalProcess& src = GetCurrentLogicalProcess();
+    Scheduler::Event ev;
+    ev.impl = MakeEvent([this]() { Stop(); });
+    ev.key.m_ts = src.currentTs + delay.GetTimeStep();
+    ev.key.m_context = Simulator::NO_CONTEXT;
+    ev.key.m_uid = EventId::UID::INVALID;
+
+    if (!m_parallel)
+    {
+        uint32_t uid = Insert(*m_lps[0], ev);
+        return EventId(ev.impl, ev.key.m_ts, ev.key.m_context, uid);
+    }
+    // From a node, the public logical process is only reached through the
+    // outbox, which is too late for a stop within the current window
+    if (ev.key.m_ts < m_windowEnd)
+    {
+        StopAt(ev.key.m_ts);
+    }
+    else
+    {
+        src.outbox[0].push_back(ev);
+    }
+    return EventId(ev.impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::StopAt(uint64_t ts)
+{
+    uint64_t stopTs = m_stopTs.load();
+    while (ts < stopTs && !m_stopTs.compare_exchange_weak(stopTs, ts))
+    {
+    }
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    LogicalProcess& lp = GetCurrentLogicalProcess();
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = lp.currentTs + delay.GetTimeStep();
+    ev.key.m_context = lp.currentContext;
+    uint32_t uid = Insert(lp, ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+
+    LogicalProcess& src = GetCurrentLogicalProcess();
+    LogicalProcess& dst = GetLogicalProcess(context);
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = src.currentTs + delay.GetTimeStep();
+    ev.key.m_context = context;
+    ev.key.m_uid = EventId::UID::INVALID;
+
+    if (!m_parallel || &src == &dst)
+    {
+        Insert(dst, ev);
+        return;
+    }
+    NS_ABORT_MSG_IF(ev.key.m_ts < m_windowEnd,
+                    "Event for context " << context << " scheduled at " << TimeStep(ev.key.m_ts)
+                                         << ", within the lookahead window ending at "
+                                         << TimeStep(m_windowEnd));
+    src.outbox[dst.id].push_back(ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_ASSERT_MSG(!m_parallel && m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+    EventId id(Ptr<EventImpl>(event, false),
+               GetCurrentLogicalProcess().currentTs,
+               0xffffffff,
+               EventId::UID::DESTROY);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentLogicalProcess().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    return TimeStep(id.GetTs() - GetCurrentLogicalProcess().currentTs);
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    GetLogicalProcess(id.GetContext()).events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    const LogicalProcess& lp = GetLogicalProcess(id.GetContext());
+    return id.PeekEventImpl() == nullptr || id.GetTs() < lp.currentTs ||
+           (id.GetTs() == lp.currentTs && id.GetUid() <= lp.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentLogicalProcess().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& lp : m_lps)
+    {
+        count += lp->eventCount;
+    }
+    return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNLogicalProcesses() const
+{
+    return m_lps.size() - 1;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return (m_lookahead == NO_TIMESTAMP) ? GetMaximumSimulationTime() : TimeStep(m_lookahead);
+}
+
+} // namespace ns3
@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-id.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \defgroup mtp Multithreaded Parallel Simulation
+ *
+ * Conservative parallel simulation of a single process over several
+ * threads, without MPI.
+ */
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Simulator implementation running the nodes of a single process on
+ * several threads.
+ *
+ * When Run() is first called, the nodes are partitioned into logical
+ * processes (LPs): nodes connected by any channel other than a pure delay
+ * line end up in the same LP. The channels recognized as delay lines are the
+ * PointToPointChannel and the SimpleChannel with a non-zero "Delay"; the
+ * smallest delay among them is the lookahead of the simulation.
+ *
+ * The simulation then advances by windows. Given the earliest pending event
+ * at time T, every LP independently runs its events earlier than T plus the
+ * lookahead, on a pool of up to MaxThreads threads. An event scheduled for a
+ * node of another LP cannot fall in the current window, so it is stored in
+ * the outbox of the sending LP, which only its own thread writes, and the
+ * outboxes are delivered at the barrier ending the window.
+ *
+ * Events without a node context, or for a node created after the partition,
+ * belong to a public LP whose events are run alone, by a single thread,
+ * between two windows; they may access any node. At a given timestamp, the
+ * public events run before the events of the nodes.
+ *
+ * Stop(delay) schedules the stop in the public LP, so that it bounds the
+ * windows and all LPs stop at the same point. Stop() called from an event of
+ * a node records the time of this event: every LP stops before its events
+ * later than it, except those it has already run in the current window.
+ *
+ * This implementation is only available when ns-3 is configured with
+ * NS3_MTP, which makes the reference counts of the objects and packets
+ * shared between threads atomic. The models run in parallel must not share
+ * other mutable state between nodes of different LPs, and Simulator::Cancel
+ * and Simulator::Remove may only be used on events of the calling LP.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * \return The number of logical processes holding nodes, zero before
+     * the first call to Run().
+     */
+    uint32_t GetNLogicalProcesses() const;
+
+    /**
+     * \return The lookahead of the simulation, or
+     * GetMaximumSimulationTime() if the nodes could not be split.
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** A logical process: a set of nodes and their events. */
+    struct LogicalProcess
+    {
+        uint32_t id{0};                             //!< Index of the LP.
+        Ptr<Scheduler> events;                      //!< The event queue.
+        uint64_t currentTs{0};                      //!< Timestamp of the current event.
+        uint32_t currentUid{EventId::UID::INVALID}; //!< Uid of the current event.
+        uint32_t currentContext{0xffffffff};        //!< Context of the current event.
+        uint32_t uid{EventId::UID::VALID};          //!< Next event uid.
+        uint64_t eventCount{0};                     //!< Number of events run.
+        /** Events for the other LPs scheduled during the current window. */
+        std::vector<std::vector<Scheduler::Event>> outbox;
+    };
+
+    /** Split the nodes into logical processes and compute the lookahead. */
+    void Partition();
+
+    /**
+     * Deliver the outboxes, then run the public events until the next window
+     * can be run in parallel.
+     *
+     * \return false if the simulation is over.
+     */
+    bool Synchronize();
+
+    /**
+     * Run the events of a logical process within the current window.
+     *
+     * \param [in] lp The logical process.
+     */
+    void ProcessWindow(LogicalProcess& lp);
+
+    /**
+     * Stop the logical processes before their events later than a time, and
+     * the simulation at the end of the current window.
+     *
+     * \param [in] ts The time of the last events to run, in time steps.
+     */
+    void StopAt(uint64_t ts);
+
+    /**
+     * Run an event removed from the queue of a logical process.
+     *
+     * \param [in] lp The logical process.
+     * \param [in] next The event.
+     */
+    void ProcessOneEvent(LogicalProcess& lp, const Scheduler::Event& next);
+
+    /**
+     * \param [in] context A context.
+     * \return The logical process running the events with this context.
+     */
+    LogicalProcess& GetLogicalProcess(uint32_t context) const;
+
+    /**
+     * \return The logical process of the calling thread.
+     */
+    LogicalProcess& GetCurrentLogicalProcess() const;
+
+    /**
+     * Insert an event in a logical process, giving it a uid.
+     *
+     * \param [in] lp The logical process.
+     * \param [in] ev The event.
+     * \return The uid of the event.
+     */
+    uint32_t Insert(LogicalProcess& lp, Scheduler::Event ev);
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+
+    /** The logical processes; the first one is the public one. */
+    std::vector<std::unique_ptr<LogicalProcess>> m_lps;
+    /** Index of the logical process of each node. */
+    std::vector<uint32_t> m_nodeLps;
+    /** Whether the nodes have been partitioned. */
+    bool m_partitioned;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookahead;
+    /** Maximum number of threads. */
+    uint32_t m_maxThreads;
+    /** The scheduler factory. */
+    ObjectFactory m_schedulerFactory;
+
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Time of the last events to run in the current window, in time steps. */
+    std::atomic<uint64_t> m_stopTs;
+    /** Whether a window is being run in parallel. */
+    bool m_parallel;
+    /** End (excluded) of the current window, in time steps. */
+    uint64_t m_windowEnd;
+    /** Next logical process to be run in the current window. */
+    std::atomic<uint32_t> m_nextLp;
+    /** Main thread. */
+    std::thread::id m_mainThreadId;
+
+    /** Logical process run by the calling thread, if any. */
+    static thread_local LogicalProcess* g_currentLp;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,382 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#ifdef NS3_MTP_TEST_POINT_TO_POINT
+#include "ns3/point-to-point-helper.h"
+#endif
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * Multithreaded simulator implementation test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulation tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Run a ring of nodes relaying packets to their neighbour with the default
+ * and the multithreaded simulator implementations, and check that the
+ * packets are received at the same times.
+ */
+class MtpRingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] maxThreads Maximum number of threads of the multithreaded
+     * simulator implementation.
+     */
+    MtpRingTestCase(uint32_t maxThreads);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Build the ring and run the simulation.
+     *
+     * \param [in] type The simulator implementation type.
+     * \return The reception times of each node.
+     */
+    std::vector<std::vector<Time>> RunRing(std::string type);
+
+    /**
+     * Send a packet to the next node of the ring.
+     *
+     * \param [in] node The index of the sending node.
+     */
+    void Send(uint32_t node);
+
+    /**
+     * Receive a packet and relay it to the next node after a processing delay.
+     *
+     * \param [in] device The receiving device.
+     * \param [in] packet The packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The sender address.
+     * \return true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    /** Number of nodes in the ring. */
+    static constexpr uint32_t N_NODES = 8;
+
+    uint32_t m_maxThreads;                   //!< Maximum number of threads.
+    std::vector<Ptr<NetDevice>> m_next;      //!< Device of each node to the next node.
+    std::vector<std::vector<Time>> m_rxTime; //!< Reception times of each node.
+    uint32_t m_nLps;                         //!< Number of logical processes.
+    Time m_lookahead;                        //!< Lookahead of the simulation.
+};
+
+MtpRingTestCase::MtpRingTestCase(uint32_t maxThreads)
+    : TestCase("Ring of nodes with " + std::to_string(maxThreads) + " threads"),
+      m_maxThreads(maxThreads),
+      m_nLps(0)
+{
+}
+
+void
+MtpRingTestCase::Send(uint32_t node)
+{
+    m_next[node]->Send(Create<Packet>(100), m_next[node]->GetBroadcast(), 0x800);
+}
+
+bool
+MtpRingTestCase::Receive(Ptr<NetDevice> device,
+                         Ptr<const Packet> packet,
+                         uint16_t protocol,
+                         const Address& from)
+{
+    uint32_t node = device->GetNode()->GetId();
+    if (node >= N_NODES)
+    {
+        return true;
+    }
+    m_rxTime[node].push_back(Simulator::Now());
+    if (Simulator::Now() < MilliSeconds(100))
+    {
+        Simulator::Schedule(MicroSeconds(node + 1), &MtpRingTestCase::Send, this, node);
+    }
+    return true;
+}
+
+std::vector<std::vector<Time>>
+MtpRingTestCase::RunRing(std::string type)
+{
+    GlobalValue::Bind("SimulatorImplementationType", StringValue(type));
+    m_next.clear();
+    m_rxTime.assign(N_NODES, {});
+
+    NodeContainer nodes;
+    nodes.Create(N_NODES);
+    SimpleNetDeviceHelper helper;
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NetDeviceContainer devices =
+            helper.Install(NodeContainer(nodes.Get(i), nodes.Get((i + 1) % N_NODES)));
+        m_next.push_back(devices.Get(0));
+    }
+    // A node attached to the first one without delay shares its logical process
+    Ptr<Node> stub = CreateObject<Node>();
+    helper.SetChannelAttribute("Delay", TimeValue(Time(0)));
+    helper.Install(NodeContainer(nodes.Get(0), stub));
+
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        for (uint32_t j = 0; j < nodes.Get(i)->GetNDevices(); j++)
+        {
+            nodes.Get(i)->GetDevice(j)->SetReceiveCallback(
+                MakeCallback(&MtpRingTestCase::Receive, this));
+        }
+        Simulator::ScheduleWithContext(i, MicroSeconds(10 * i), &MtpRingTestCase::Send, this, i);
+    }
+
+    Simulator::Run();
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        m_nLps = impl->GetNLogicalProcesses();
+        m_lookahead = impl->GetLookahead();
+    }
+    Simulator::Destroy();
+    return m_rxTime;
+}
+
+void
+MtpRingTestCase::DoRun()
+{
+    std::vector<std::vector<Time>> expected = RunRing("ns3::DefaultSimulatorImpl");
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(m_maxThreads));
+    std::vector<std::vector<Time>> actual = RunRing("ns3::MultithreadedSimulatorImpl");
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+
+    NS_TEST_ASSERT_MSG_EQ(m_nLps, N_NODES, "Wrong number of logical processes");
+    NS_TEST_ASSERT_MSG_EQ(m_lookahead, MilliSeconds(1), "Wrong lookahead");
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NS_TEST_ASSERT_MSG_GT(expected[i].size(), 10, "Too few packets received by node " << i);
+        NS_TEST_ASSERT_MSG_EQ(actual[i].size(),
+                              expected[i].size(),
+                              "Wrong number of packets received by node " << i);
+        for (std::size_t j = 0; j < expected[i].size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(actual[i][j], expected[i][j], "Wrong reception time");
+        }
+    }
+}
+
+#ifdef NS3_MTP_TEST_POINT_TO_POINT
+/**
+ * \ingroup mtp-tests
+ *
+ * Run a ring of nodes connected by point-to-point links, relaying packets to
+ * their neighbour until one of them stops the simulation, with the default
+ * and the multithreaded simulator implementations, and check that the
+ * packets are received at the same times.
+ */
+class MtpPointToPointTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] maxThreads Maximum number of threads of the multithreaded
+     * simulator implementation.
+     */
+    MtpPointToPointTestCase(uint32_t maxThreads);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Build the ring and run the simulation.
+     *
+     * \param [in] type The simulator implementation type.
+     * \return The reception times of each node.
+     */
+    std::vector<std::vector<Time>> RunRing(std::string type);
+
+    /**
+     * Send a packet to the next node of the ring.
+     *
+     * \param [in] node The index of the sending node.
+     */
+    void Send(uint32_t node);
+
+    /**
+     * Receive a packet and relay it to the next node after a processing
+     * delay. The first packet received by the last node stops the simulation
+     * a while later.
+     *
+     * \param [in] device The receiving device.
+     * \param [in] packet The packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The sender address.
+     * \return true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    /** Number of nodes in the ring. */
+    static constexpr uint32_t N_NODES = 6;
+
+    uint32_t m_maxThreads;                   //!< Maximum number of threads.
+    std::vector<Ptr<NetDevice>> m_next;      //!< Device of each node to the next node.
+    std::vector<std::vector<Time>> m_rxTime; //!< Reception times of each node.
+    uint32_t m_nLps;                         //!< Number of logical processes.
+    Time m_lookahead;                        //!< Lookahead of the simulation.
+};
+
+MtpPointToPointTestCase::MtpPointToPointTestCase(uint32_t maxThreads)
+    : TestCase("Ring of point-to-point links with " + std::to_string(maxThreads) + " threads"),
+      m_maxThreads(maxThreads),
+      m_nLps(0)
+{
+}
+
+void
+MtpPointToPointTestCase::Send(uint32_t node)
+{
+    m_next[node]->Send(Create<Packet>(100), m_next[node]->GetBroadcast(), 0x800);
+}
+
+bool
+MtpPointToPointTestCase::Receive(Ptr<NetDevice> device,
+                                 Ptr<const Packet> packet,
+                                 uint16_t protocol,
+                                 const Address& from)
+{
+    uint32_t node = device->GetNode()->GetId();
+    m_rxTime[node].push_back(Simulator::Now());
+    if (node == N_NODES - 1 && m_rxTime[node].size() == 1)
+    {
+        Simulator::Stop(MilliSeconds(50));
+    }
+    Simulator::Schedule(MicroSeconds(node + 1), &MtpPointToPointTestCase::Send, this, node);
+    return true;
+}
+
+std::vector<std::vector<Time>>
+MtpPointToPointTestCase::RunRing(std::string type)
+{
+    GlobalValue::Bind("SimulatorImplementationType", StringValue(type));
+    m_next.clear();
+    m_rxTime.assign(N_NODES, {});
+
+    NodeContainer nodes;
+    nodes.Create(N_NODES);
+    PointToPointHelper helper;
+    helper.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        // The last link has no delay, so that its nodes share a logical process
+        Time delay = (i == N_NODES - 1) ? Time(0) : MilliSeconds(2 + i % 2);
+        helper.SetChannelAttribute("Delay", TimeValue(delay));
+        NetDeviceContainer devices =
+            helper.Install(NodeContainer(nodes.Get(i), nodes.Get((i + 1) % N_NODES)));
+        m_next.push_back(devices.Get(0));
+    }
+
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        for (uint32_t j = 0; j < nodes.Get(i)->GetNDevices(); j++)
+        {
+            nodes.Get(i)->GetDevice(j)->SetReceiveCallback(
+                MakeCallback(&MtpPointToPointTestCase::Receive, this));
+        }
+        Simulator::ScheduleWithContext(i,
+                                       MicroSeconds(10 * i),
+                                       &MtpPointToPointTestCase::Send,
+                                       this,
+                                       i);
+    }
+
+    Simulator::Run();
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        m_nLps = impl->GetNLogicalProcesses();
+        m_lookahead = impl->GetLookahead();
+    }
+    Simulator::Destroy();
+    return m_rxTime;
+}
+
+void
+MtpPointToPointTestCase::DoRun()
+{
+    std::vector<std::vector<Time>> expected = RunRing("ns3::DefaultSimulatorImpl");
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(m_maxThreads));
+    std::vector<std::vector<Time>> actual = RunRing("ns3::MultithreadedSimulatorImpl");
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+
+    NS_TEST_ASSERT_MSG_EQ(m_nLps, N_NODES - 1, "Wrong number of logical processes");
+    NS_TEST_ASSERT_MSG_EQ(m_lookahead, MilliSeconds(2), "Wrong lookahead");
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NS_TEST_ASSERT_MSG_GT(expected[i].size(), 10, "Too few packets received by node " << i);
+        NS_TEST_ASSERT_MSG_EQ(actual[i].size(),
+                              expected[i].size(),
+                              "Wrong number of packets received by node " << i);
+        for (std::size_t j = 0; j < expected[i].size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(actual[i][j], expected[i][j], "Wrong reception time");
+        }
+    }
+}
+#endif
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Multithreaded simulator implementation test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", Type::UNIT)
+{
+    AddTestCase(new MtpRingTestCase(1), TestCase::Duration::QUICK);
+    AddTestCase(new MtpRingTestCase(4), TestCase::Duration::QUICK);
+#ifdef NS3_MTP_TEST_POINT_TO_POINT
+    AddTestCase(new MtpPointToPointTestCase(1), TestCase::Duration::QUICK);
+    AddTestCase(new MtpPointToPointTestCase(4), TestCase::Duration::QUICK);
+#endif
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
@@ -43,7 +43,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -238,7 +242,7 @@ Buffer::Initialize(uint32_t zeroSize)
 {
     NS_LOG_FUNCTION(this << zeroSize);
     m_data = Buffer::Create(0);
-    m_start = std::min(m_data->m_size, g_recommendedStart);
+    m_start = std::min<uint32_t>(m_data->m_size, g_recommendedStart);
     m_maxZeroAreaStart = m_start;
     m_zeroAreaStart = m_start;
     m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
@@ -255,15 +259,14 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
         m_data = o.m_data;
         m_data->m_count++;
     }
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
+    g_recommendedStart = std::max<uint32_t>(g_recommendedStart, m_maxZeroAreaStart);
     m_maxZeroAreaStart = o.m_maxZeroAreaStart;
     m_zeroAreaStart = o.m_zeroAreaStart;
     m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -277,9 +280,8 @@ Buffer::~Buffer()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    g_recommendedStart = std::max<uint32_t>(g_recommendedStart, m_maxZeroAreaStart);
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
@@ -322,8 +324,7 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -368,8 +369,7 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -396,9 +396,36 @@ Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    bool adjacentZeroAreas = (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
+                             o.m_start == o.m_zeroAreaStart &&
+                             o.m_zeroAreaEnd - o.m_zeroAreaStart > 0;
+    if (adjacentZeroAreas && (m_data->m_count > 1 || m_end != m_data->m_dirtyEnd))
+    {
+        /**
+         * The buffer is shared, typically with the other fragments of the
+         * same packet being reassembled. Rather than a full copy, which
+         * would allocate the zero areas, copy only the bytes outside of
+         * the zero area, so that the optimization below kicks in.
+         */
+        uint32_t internalSize = GetInternalSize();
+        Buffer::Data* newData = Buffer::Create(internalSize);
+        memcpy(newData->m_data, m_data->m_data + m_start, internalSize);
+        if (--m_data->m_count == 0)
+        {
+            Buffer::Recycle(m_data);
+        }
+        m_data = newData;
+
+        int32_t delta = -m_start;
+        m_zeroAreaStart += delta;
+        m_zeroAreaEnd += delta;
+        m_end += delta;
+        m_start += delta;
+
+        m_data->m_dirtyStart = m_start;
+        m_data->m_dirtyEnd = m_end;
+    }
+    if (adjacentZeroAreas)
     {
         /**
          * This is an optimization which kicks in when
@@ -821,25 +848,29 @@ Buffer::Iterator::Write(Iterator start, Iterator end)
     NS_ASSERT(m_data != start.m_data);
     uint32_t size = end.m_current - start.m_current;
     NS_ASSERT_MSG(CheckNoZero(m_current, m_current + size), GetWriteErrorMessage());
+    // The destination is either before or after the zero area
+    uint8_t* to = &m_data[m_current < m_zeroStart ? m_current
+                                                  : m_current - (m_zeroEnd - m_zeroStart)];
     if (start.m_current <= start.m_zeroStart)
     {
         uint32_t toCopy = std::min(size, start.m_zeroStart - start.m_current);
-        memcpy(&m_data[m_current], &start.m_data[start.m_current], toCopy);
+        memcpy(to, &start.m_data[start.m_current], toCopy);
         start.m_current += toCopy;
         m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     if (start.m_current <= start.m_zeroEnd)
     {
         uint32_t toCopy = std::min(size, start.m_zeroEnd - start.m_current);
-        memset(&m_data[m_current], 0, toCopy);
+        memset(to, 0, toCopy);
         start.m_current += toCopy;
         m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     uint32_t toCopy = std::min(size, start.m_dataEnd - start.m_current);
     uint8_t* from = &start.m_data[start.m_current - (start.m_zeroEnd - start.m_zeroStart)];
-    uint8_t* to = &m_data[m_current];
     memcpy(to, from, toCopy);
     m_current += toCopy;
 }
@@ -13,8 +13,14 @@
 #include <ostream>
 #include <stdint.h>
 #include <vector>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
+// The free list is not shared between the threads of a multithreaded simulation
+#ifndef NS3_MTP
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -654,7 +660,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -758,7 +768,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
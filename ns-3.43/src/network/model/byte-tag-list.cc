@@ -12,8 +12,14 @@
 #include <cstring>
 #include <limits>
 #include <vector>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
+// The free list is not shared between the threads of a multithreaded simulation
+#ifndef NS3_MTP
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
@@ -32,7 +38,11 @@ NS_LOG_COMPONENT_DEFINE("ByteTagList");
 struct ByteTagListData
 {
     uint32_t size;   //!< size of the data
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; //!< use counter (for smart deallocation)
+#else
     uint32_t count;  //!< use counter (for smart deallocation)
+#endif
     uint32_t dirty;  //!< number of bytes actually in use
     uint8_t data[4]; //!< data
 };
@@ -375,8 +385,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
         return;
     }
     g_maxSize = std::max(g_maxSize, data->size);
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
@@ -412,8 +421,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
     {
         return;
     }
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
@@ -69,8 +69,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -556,6 +555,9 @@ PacketMetadata::Data*
 PacketMetadata::Create(uint32_t size)
 {
     NS_LOG_FUNCTION(size);
+#ifdef NS3_MTP
+    return PacketMetadata::Allocate(size);
+#else
     NS_LOG_LOGIC("create size=" << size << ", max=" << m_maxSize);
     if (size > m_maxSize)
     {
@@ -576,12 +578,17 @@ PacketMetadata::Create(uint32_t size)
     }
     NS_LOG_LOGIC("create alloc size=" << m_maxSize);
     return PacketMetadata::Allocate(m_maxSize);
+#endif
 }
 
 void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
+#ifdef NS3_MTP
+    // The free list is not shared between the threads of a multithreaded simulation
+    PacketMetadata::Deallocate(data);
+#else
     if (!m_enable)
     {
         PacketMetadata::Deallocate(data);
@@ -597,6 +604,7 @@ PacketMetadata::Recycle(PacketMetadata::Data* data)
     {
         m_freeList.push_back(data);
     }
+#endif
 }
 
 PacketMetadata::Data*
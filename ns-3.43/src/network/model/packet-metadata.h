@@ -17,6 +17,9 @@
 #include <limits>
 #include <stdint.h>
 #include <vector>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 namespace ns3
 {
@@ -415,7 +418,11 @@ class PacketMetadata
     struct Data
     {
         /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /** size (in bytes) of m_data buffer below */
         uint32_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
@@ -728,8 +735,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
     {
         // not self assignment
         NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
@@ -747,8 +753,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
 PacketMetadata::~PacketMetadata()
 {
     NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
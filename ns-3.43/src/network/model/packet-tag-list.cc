@@ -18,14 +18,65 @@
 
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/pool-allocator.h"
 
 #include <cstring>
+#include <limits>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+/**
+ * The slot of each hot tag type plus one, indexed by TypeId uid, zero for
+ * the other types. This is constant initialized, so that the tags can be
+ * registered during the static initialization of the modules.
+ */
+static int8_t g_hotSlots[std::numeric_limits<uint16_t>::max() + 1];
+/** The number of hot tag types. */
+static uint32_t g_nHotTags = 0;
+
+/**
+ * \returns The type of the hot tags of each slot.
+ */
+static std::array<TypeId, PacketTagList::HOT_TAGS>&
+GetHotTypeIds()
+{
+    static std::array<TypeId, PacketTagList::HOT_TAGS> tids;
+    return tids;
+}
+
+bool
+PacketTagList::RegisterHotTag(TypeId tid)
+{
+    // No logging, since this may run before the log component is constructed
+    if (GetHotSlot(tid) >= 0)
+    {
+        return true;
+    }
+    if (g_nHotTags == HOT_TAGS)
+    {
+        return false;
+    }
+    GetHotTypeIds()[g_nHotTags] = tid;
+    g_hotSlots[tid.GetUid()] = static_cast<int8_t>(++g_nHotTags);
+    return true;
+}
+
+TypeId
+PacketTagList::GetHotTagTypeId(uint32_t slot)
+{
+    NS_ASSERT(slot < g_nHotTags);
+    return GetHotTypeIds()[slot];
+}
+
+int32_t
+PacketTagList::GetHotSlot(TypeId tid)
+{
+    return g_hotSlots[tid.GetUid()] - 1;
+}
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -33,7 +84,7 @@ PacketTagList::CreateTagData(size_t dataSize)
                   "Requested TagData size " << dataSize << " exceeds maximum "
                                             << std::numeric_limits<decltype(TagData::size)>::max());
 
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
+    void* p = PoolAllocator::Allocate(sizeof(TagData) + dataSize - 1);
     // The matching frees are in RemoveAll and RemoveWriter
 
     auto tag = new (p) TagData;
@@ -41,6 +92,14 @@ PacketTagList::CreateTagData(size_t dataSize)
     return tag;
 }
 
+void
+PacketTagList::FreeTagData(TagData* tag)
+{
+    size_t dataSize = tag->size;
+    tag->~TagData();
+    PoolAllocator::Deallocate(tag, sizeof(TagData) + dataSize - 1);
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -164,6 +223,14 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove(Tag& tag)
 {
+    int32_t slot = GetHotSlot(tag.GetInstanceTypeId());
+    if (slot >= 0 && (m_hotMask & (1 << slot)))
+    {
+        HotTag& hot = m_hot[slot];
+        tag.Deserialize(TagBuffer(hot.data, hot.data + hot.size));
+        m_hotMask &= ~(1 << slot);
+        return true;
+    }
     return COWTraverse(tag, &PacketTagList::RemoveWriter);
 }
 
@@ -184,8 +251,7 @@ PacketTagList::RemoveWriter(Tag& tag,
     if (preMerge)
     {
         // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
+        FreeTagData(cur);
     }
     else
     {
@@ -204,6 +270,24 @@ PacketTagList::RemoveWriter(Tag& tag,
 bool
 PacketTagList::Replace(Tag& tag)
 {
+    int32_t slot = GetHotSlot(tag.GetInstanceTypeId());
+    if (slot >= 0 && (m_hotMask & (1 << slot)))
+    {
+        uint32_t size = tag.GetSerializedSize();
+        if (size <= HOT_TAG_SIZE)
+        {
+            HotTag& hot = m_hot[slot];
+            hot.size = size;
+            tag.Serialize(TagBuffer(hot.data, hot.data + size));
+        }
+        else
+        {
+            // Does not fit any more, move it to the list
+            m_hotMask &= ~(1 << slot);
+            Add(tag);
+        }
+        return true;
+    }
     bool found = COWTraverse(tag, &PacketTagList::ReplaceWriter);
     if (!found)
     {
@@ -251,14 +335,28 @@ void
 PacketTagList::Add(const Tag& tag) const
 {
     NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
+    int32_t slot = GetHotSlot(tag.GetInstanceTypeId());
     // ensure this id was not yet added
+    NS_ASSERT_MSG(slot < 0 || !(m_hotMask & (1 << slot)),
+                  "Error: cannot add the same kind of tag twice. The tag type is "
+                      << tag.GetInstanceTypeId().GetName());
     for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
         NS_ASSERT_MSG(cur->tid != tag.GetInstanceTypeId(),
                       "Error: cannot add the same kind of tag twice. The tag type is "
                           << tag.GetInstanceTypeId().GetName());
     }
-    TagData* head = CreateTagData(tag.GetSerializedSize());
+    uint32_t size = tag.GetSerializedSize();
+    if (slot >= 0 && size <= HOT_TAG_SIZE)
+    {
+        auto self = const_cast<PacketTagList*>(this);
+        HotTag& hot = self->m_hot[slot];
+        hot.size = size;
+        tag.Serialize(TagBuffer(hot.data, hot.data + size));
+        self->m_hotMask |= 1 << slot;
+        return;
+    }
+    TagData* head = CreateTagData(size);
     head->count = 1;
     head->next = nullptr;
     head->tid = tag.GetInstanceTypeId();
@@ -273,6 +371,13 @@ PacketTagList::Peek(Tag& tag) const
 {
     NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
     TypeId tid = tag.GetInstanceTypeId();
+    int32_t slot = GetHotSlot(tid);
+    if (slot >= 0 && (m_hotMask & (1 << slot)))
+    {
+        auto data = const_cast<uint8_t*>(m_hot[slot].data);
+        tag.Deserialize(TagBuffer(data, data + m_hot[slot].size));
+        return true;
+    }
     for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
         if (cur->tid == tid)
@@ -301,17 +406,29 @@ PacketTagList::GetSerializedSize() const
 
     size = 4; // numberOfTags
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
-    {
-        size += 4; // TagData -> size
+    auto tagSize = [](uint32_t dataSize) {
+        uint32_t size = 4; // TagData -> size
 
         // TypeId hash; ensure size is multiple of 4 bytes
         uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
         size += hashSize;
 
         // TagData -> data; ensure size is multiple of 4 bytes
-        uint32_t tagWordSize = (cur->size + 3) & (~3);
+        uint32_t tagWordSize = (dataSize + 3) & (~3);
         size += tagWordSize;
+        return size;
+    };
+
+    for (uint32_t slot = 0; slot < HOT_TAGS; ++slot)
+    {
+        if (const HotTag* hot = GetHotTag(slot))
+        {
+            size += tagSize(hot->size);
+        }
+    }
+    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    {
+        size += tagSize(cur->size);
     }
 
     return size;
@@ -335,18 +452,17 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
     uint32_t* numberOfTags = p;
     *p++ = 0;
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
-    {
+    auto serializeTag = [&](TypeId tagTid, uint32_t dataSize, const uint8_t* data) {
         size += 4;
 
         if (size > maxSize)
         {
-            return 0;
+            return false;
         }
 
-        *p++ = cur->size;
+        *p++ = dataSize;
 
-        NS_LOG_INFO("Serializing tag id " << cur->tid);
+        NS_LOG_INFO("Serializing tag id " << tagTid);
 
         // ensure size is multiple of 4 bytes for 4 byte boundaries
         uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
@@ -354,26 +470,43 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
 
         if (size > maxSize)
         {
-            return 0;
+            return false;
         }
 
-        TypeId::hash_t tid = cur->tid.GetHash();
+        TypeId::hash_t tid = tagTid.GetHash();
         memcpy(p, &tid, sizeof(TypeId::hash_t));
         p += hashSize / 4;
 
         // ensure size is multiple of 4 bytes for 4 byte boundaries
-        uint32_t tagWordSize = (cur->size + 3) & (~3);
+        uint32_t tagWordSize = (dataSize + 3) & (~3);
         size += tagWordSize;
 
         if (size > maxSize)
         {
-            return 0;
+            return false;
         }
 
-        memcpy(p, cur->data, cur->size);
+        memcpy(p, data, dataSize);
         p += tagWordSize / 4;
 
         (*numberOfTags)++;
+        return true;
+    };
+
+    for (uint32_t slot = 0; slot < HOT_TAGS; ++slot)
+    {
+        const HotTag* hot = GetHotTag(slot);
+        if (hot != nullptr && !serializeTag(GetHotTagTypeId(slot), hot->size, hot->data))
+        {
+            return 0;
+        }
+    }
+    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    {
+        if (!serializeTag(cur->tid, cur->size, cur->data))
+        {
+            return 0;
+        }
     }
 
     // Serialized successfully
@@ -411,6 +544,21 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
         NS_LOG_INFO("Deserializing tag of type " << tid);
 
+        int32_t slot = GetHotSlot(tid);
+        if (slot >= 0 && tagSize <= HOT_TAG_SIZE)
+        {
+            NS_ASSERT(sizeCheck >= tagSize);
+            m_hot[slot].size = tagSize;
+            memcpy(m_hot[slot].data, p, tagSize);
+            m_hotMask |= 1 << slot;
+
+            // ensure 4 byte boundary
+            uint32_t tagWordSize = (tagSize + 3) & (~3);
+            p += tagWordSize / 4;
+            sizeCheck -= tagWordSize;
+            continue;
+        }
+
         TagData* newTag = CreateTagData(tagSize);
         newTag->count = 1;
         newTag->next = nullptr;
@@ -425,7 +573,7 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
         sizeCheck -= tagWordSize;
 
         // Set link list pointers.
-        if (i == 0)
+        if (prevTag == nullptr)
         {
             m_next = newTag;
         }
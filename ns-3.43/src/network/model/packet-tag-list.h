@@ -15,8 +15,12 @@
 
 #include "ns3/type-id.h"
 
+#include <array>
 #include <ostream>
 #include <stdint.h>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 namespace ns3
 {
@@ -109,6 +113,20 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Hot tags </b>
+ *
+ *   - A few tag types, which are added to most packets and peeked at every
+ *     hop, can be registered by #RegisterHotTag. Each gets a slot in every
+ *     PacketTagList, indexed by the TypeId uid, which stores the serialized
+ *     tag inline, up to HOT_TAG_SIZE bytes.
+ *
+ *   - #Add, #Peek, #Remove and #Replace of a hot tag are a lookup of its
+ *     slot, without allocation nor traversal. The slots are copied with the
+ *     PacketTagList, so copy-on-write does not apply to them.
+ *
+ *   - The hot tags which do not fit in their slot, and all the other tags,
+ *     are stored in the list.
  */
 class PacketTagList
 {
@@ -131,12 +149,63 @@ class PacketTagList
     struct TagData
     {
         TagData* next;   //!< Pointer to next in list
+#ifdef NS3_MTP
+        std::atomic<uint32_t> count; //!< Number of incoming links
+#else
         uint32_t count;  //!< Number of incoming links
+#endif
         TypeId tid;      //!< Type of the tag serialized into #data
         uint32_t size;   //!< Size of the \c data buffer
         uint8_t data[1]; //!< Serialization buffer
     };
 
+    /**
+     * The maximum number of hot tag types.  Every PacketTagList holds a slot
+     * for each of them, so this is kept to the few tags a model resolves for
+     * every packet.
+     */
+    static constexpr uint32_t HOT_TAGS = 4;
+    /** The maximum serialized size of a hot tag stored in its slot. */
+    static constexpr uint32_t HOT_TAG_SIZE = 8;
+
+    /**
+     * Inline storage of a serialized hot tag.
+     *
+     * \internal
+     * This has to be public for PacketTagIterator, like TagData.
+     */
+    struct HotTag
+    {
+        uint8_t size;               //!< Size of the \c data buffer
+        uint8_t data[HOT_TAG_SIZE]; //!< Serialization buffer
+    };
+
+    /**
+     * Register a hot tag type, stored inline in a slot of every
+     * PacketTagList rather than in the list.
+     *
+     * This is meant to be called by the model which resolves the tag for
+     * every packet, when it is first instantiated, rather than when the
+     * TypeId is registered, so that the slots are only taken by the tags
+     * of the models in use.  The tags of this type already added to a packet
+     * stay in the list, where they are still found.
+     *
+     * \param [in] tid The type of the tag.
+     * \returns True if the type is registered, false if all the slots are
+     *          taken, in which case the tags of this type are stored in the list.
+     */
+    static bool RegisterHotTag(TypeId tid);
+    /**
+     * \param [in] slot The slot.
+     * \returns The type of the hot tags stored in \pname{slot}.
+     */
+    static TypeId GetHotTagTypeId(uint32_t slot);
+    /**
+     * \param [in] slot The slot.
+     * \returns The hot tag stored in \pname{slot}, or \c nullptr if none.
+     */
+    inline const HotTag* GetHotTag(uint32_t slot) const;
+
     /**
      * Create a new PacketTagList.
      */
@@ -204,7 +273,8 @@ class PacketTagList
      */
     inline void RemoveAll();
     /**
-     * \returns pointer to head of tag list
+     * \returns pointer to head of tag list, which does not hold the tags
+     *          stored in the hot tag slots
      */
     const PacketTagList::TagData* Head() const;
     /**
@@ -233,6 +303,12 @@ class PacketTagList
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
   private:
+    /**
+     * \param [in] tid The type of a tag.
+     * \returns The slot of \pname{tid}, or -1 if it is not a hot tag.
+     */
+    static int32_t GetHotSlot(TypeId tid);
+
     /**
      * Allocate and construct a TagData struct, sizing the data area
      * large enough to serialize dataSize bytes from a Tag.
@@ -241,6 +317,12 @@ class PacketTagList
      * \returns The newly constructed TagData object.
      */
     static TagData* CreateTagData(size_t dataSize);
+    /**
+     * Destroy and free a TagData struct allocated by CreateTagData.
+     *
+     * \param [in] tag The TagData object.
+     */
+    static void FreeTagData(TagData* tag);
 
     /**
      * Typedef of method function pointer for copy-on-write operations
@@ -294,6 +376,12 @@ class PacketTagList
      * Pointer to first \ref TagData on the list
      */
     TagData* m_next;
+    /** Bit mask of the slots holding a hot tag. */
+    uint8_t m_hotMask;
+    /** The hot tag slots. */
+    std::array<HotTag, HOT_TAGS> m_hot;
+
+    static_assert(HOT_TAGS <= 8 * sizeof(m_hotMask), "Too many hot tags for the mask");
 };
 
 } // namespace ns3
@@ -306,12 +394,16 @@ namespace ns3
 {
 
 PacketTagList::PacketTagList()
-    : m_next()
+    : m_next(),
+      m_hotMask(0),
+      m_hot{}
 {
 }
 
 PacketTagList::PacketTagList(const PacketTagList& o)
-    : m_next(o.m_next)
+    : m_next(o.m_next),
+      m_hotMask(o.m_hotMask),
+      m_hot(o.m_hot)
 {
     if (m_next != nullptr)
     {
@@ -322,17 +414,18 @@ PacketTagList::PacketTagList(const PacketTagList& o)
 PacketTagList&
 PacketTagList::operator=(const PacketTagList& o)
 {
-    // self assignment
-    if (m_next == o.m_next)
+    // self assignment, or already sharing the same list
+    if (m_next != o.m_next)
     {
-        return *this;
-    }
-    RemoveAll();
-    m_next = o.m_next;
-    if (m_next != nullptr)
-    {
-        m_next->count++;
+        RemoveAll();
+        m_next = o.m_next;
+        if (m_next != nullptr)
+        {
+            m_next->count++;
+        }
     }
+    m_hotMask = o.m_hotMask;
+    m_hot = o.m_hot;
     return *this;
 }
 
@@ -347,24 +440,28 @@ PacketTagList::RemoveAll()
     TagData* prev = nullptr;
     for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        cur->count--;
-        if (cur->count > 0)
+        if (--cur->count > 0)
         {
             break;
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            FreeTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        FreeTagData(prev);
     }
     m_next = nullptr;
+    m_hotMask = 0;
+}
+
+const PacketTagList::HotTag*
+PacketTagList::GetHotTag(uint32_t slot) const
+{
+    return (m_hotMask & (1 << slot)) ? &m_hot[slot] : nullptr;
 }
 
 } // namespace ns3
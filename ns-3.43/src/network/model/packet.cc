@@ -9,6 +9,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/pool-allocator.h"
 #include "ns3/simulator.h"
 
 #include <cstdarg>
@@ -19,7 +20,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid = 0;
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -78,42 +83,64 @@ ByteTagIterator::ByteTagIterator(ByteTagList::Iterator i)
 {
 }
 
-PacketTagIterator::PacketTagIterator(const PacketTagList::TagData* head)
-    : m_current(head)
+PacketTagIterator::PacketTagIterator(const PacketTagList& list)
+    : m_list(&list),
+      m_slot(0),
+      m_current(list.Head())
 {
+    SkipEmptySlots();
+}
+
+void
+PacketTagIterator::SkipEmptySlots()
+{
+    while (m_slot < PacketTagList::HOT_TAGS && m_list->GetHotTag(m_slot) == nullptr)
+    {
+        m_slot++;
+    }
 }
 
 bool
 PacketTagIterator::HasNext() const
 {
-    return m_current != nullptr;
+    return m_slot < PacketTagList::HOT_TAGS || m_current != nullptr;
 }
 
 PacketTagIterator::Item
 PacketTagIterator::Next()
 {
     NS_ASSERT(HasNext());
+    if (m_slot < PacketTagList::HOT_TAGS)
+    {
+        const PacketTagList::HotTag* hot = m_list->GetHotTag(m_slot);
+        TypeId tid = PacketTagList::GetHotTagTypeId(m_slot);
+        m_slot++;
+        SkipEmptySlots();
+        return PacketTagIterator::Item(tid, hot->data, hot->size);
+    }
     const PacketTagList::TagData* prev = m_current;
     m_current = m_current->next;
-    return PacketTagIterator::Item(prev);
+    return PacketTagIterator::Item(prev->tid, prev->data, prev->size);
 }
 
-PacketTagIterator::Item::Item(const PacketTagList::TagData* data)
-    : m_data(data)
+PacketTagIterator::Item::Item(TypeId tid, const uint8_t* data, uint32_t size)
+    : m_tid(tid),
+      m_data(data),
+      m_size(size)
 {
 }
 
 TypeId
 PacketTagIterator::Item::GetTypeId() const
 {
-    return m_data->tid;
+    return m_tid;
 }
 
 void
 PacketTagIterator::Item::GetTag(Tag& tag) const
 {
-    NS_ASSERT(tag.GetInstanceTypeId() == m_data->tid);
-    tag.Deserialize(TagBuffer((uint8_t*)m_data->data, (uint8_t*)m_data->data + m_data->size));
+    NS_ASSERT(tag.GetInstanceTypeId() == m_tid);
+    tag.Deserialize(TagBuffer((uint8_t*)m_data, (uint8_t*)m_data + m_size));
 }
 
 Ptr<Packet>
@@ -125,6 +152,18 @@ Packet::Copy() const
     return Ptr<Packet>(new Packet(*this), false);
 }
 
+void*
+Packet::operator new(std::size_t size)
+{
+    return PoolAllocator::Allocate(size);
+}
+
+void
+Packet::operator delete(void* ptr, std::size_t size)
+{
+    PoolAllocator::Deallocate(ptr, size);
+}
+
 Packet::Packet()
     : m_buffer(),
       m_byteTagList(),
@@ -135,10 +174,9 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -175,10 +213,9 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -202,10 +239,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -1008,7 +1044,7 @@ Packet::PrintPacketTags(std::ostream& os) const
 PacketTagIterator
 Packet::GetPacketTagIterator() const
 {
-    return PacketTagIterator(m_packetTagList.Head());
+    return PacketTagIterator(m_packetTagList);
 }
 
 std::ostream&
@@ -23,6 +23,9 @@
 #include "ns3/ptr.h"
 
 #include <stdint.h>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 namespace ns3
 {
@@ -149,10 +152,14 @@ class PacketTagIterator
         friend class PacketTagIterator;
         /**
          * Constructor
-         * \param data the data to copy.
+         * \param tid the type of the tag.
+         * \param data the serialized tag.
+         * \param size the size of the serialized tag.
          */
-        Item(const PacketTagList::TagData* data);
-        const PacketTagList::TagData* m_data; //!< the tag data
+        Item(TypeId tid, const uint8_t* data, uint32_t size);
+        TypeId m_tid;          //!< the type of the tag
+        const uint8_t* m_data; //!< the serialized tag
+        uint32_t m_size;       //!< the size of the serialized tag
     };
 
     /**
@@ -169,10 +176,16 @@ class PacketTagIterator
     friend class Packet;
     /**
      * Constructor
-     * \param head head of the items
+     * \param list the tags of the packet
      */
-    PacketTagIterator(const PacketTagList::TagData* head);
-    const PacketTagList::TagData* m_current; //!< actual position over the set of tags in a packet
+    PacketTagIterator(const PacketTagList& list);
+    /**
+     * Move to the next hot tag slot holding a tag, if any.
+     */
+    void SkipEmptySlots();
+    const PacketTagList* m_list;             //!< the tags of the packet
+    uint32_t m_slot;                         //!< actual position over the hot tags
+    const PacketTagList::TagData* m_current; //!< actual position over the other tags
 };
 
 /**
@@ -243,14 +256,28 @@ class Packet : public SimpleRefCount<Packet>
      * \return the copied object
      */
     Packet& operator=(const Packet& o);
+    /**
+     * \brief Allocate a packet from the PoolAllocator
+     * \param size the size of the packet
+     * \return the memory of the packet
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Return the memory of a packet to the PoolAllocator
+     * \param ptr the memory of the packet
+     * \param size the size of the packet
+     */
+    static void operator delete(void* ptr, std::size_t size);
     /**
      * \brief Create a packet with a zero-filled payload.
      *
-     * The memory necessary for the payload is not allocated:
-     * it will be allocated at any later point if you attempt
-     * to fragment this packet or to access the zero-filled
-     * bytes. The packet is allocated with a new uid (as
-     * returned by getUid).
+     * The memory necessary for the payload is not allocated, not
+     * even when this packet is fragmented and its fragments are
+     * reassembled: it will be allocated at any later point if you
+     * attempt to access the zero-filled bytes. A packet whose payload
+     * only matters by its size thus costs a few hundred bytes, headers
+     * included, whatever this size. The packet is allocated with a
+     * new uid (as returned by getUid).
      *
      * \param size the size of the zero-filled payload
      */
@@ -784,7 +811,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -382,6 +382,28 @@ BufferTest::DoRun()
     val2 <<= 8;
     val2 |= i.ReadU8();
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
+
+    // Reassembling the fragments of a zero-filled buffer, which share its
+    // data, does not allocate the zero area
+    buffer = Buffer(3000);
+    buffer.AddAtStart(2);
+    i = buffer.Begin();
+    i.WriteU8(0x1);
+    i.WriteU8(0x2);
+    buffer.AddAtEnd(1);
+    i = buffer.End();
+    i.Prev();
+    i.WriteU8(0x3);
+    Buffer first = buffer.CreateFragment(0, 1500);
+    Buffer second = buffer.CreateFragment(1500, 1503);
+    first.AddAtEnd(second);
+    NS_TEST_ASSERT_MSG_EQ(first.GetSize(), 3003, "Bad reassembled size");
+    NS_TEST_ASSERT_MSG_LT(first.GetSerializedSize(), 100, "Zero area allocated");
+    i = first.End();
+    i.Prev();
+    NS_TEST_ASSERT_MSG_EQ(i.ReadU8(), 0x3, "Bad byte after the zero area");
+    ENSURE_WRITTEN_BYTES(first, 4, 0x1, 0x2, 0x00, 0x00);
+    ENSURE_WRITTEN_BYTES(buffer, 4, 0x1, 0x2, 0x00, 0x00);
 }
 
 /**
@@ -7,6 +7,7 @@
  */
 #include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
+#include "ns3/pool-allocator.h"
 #include "ns3/test.h"
 
 #include <cstdarg>
@@ -15,6 +16,7 @@
 #include <iostream>
 #include <limits> // std:numeric_limits
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -152,6 +154,84 @@ class ATestTag : public ATestTagBase
     }
 };
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Template class for Test tags of a given size, to be registered
+ * as hot tags
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+template <int N, uint32_t SIZE>
+class AHotTestTag : public ATestTagBase
+{
+  public:
+    /**
+     * Register this type.
+     * \return The TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        std::ostringstream oss;
+        oss << "anon::AHotTestTag<" << N << ">";
+        static TypeId tid = TypeId(oss.str())
+                                .SetParent<ATestTagBase>()
+                                .SetGroupName("Network")
+                                .HideFromDocumentation()
+                                .AddConstructor<AHotTestTag<N, SIZE>>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+
+    uint32_t GetSerializedSize() const override
+    {
+        return SIZE;
+    }
+
+    void Serialize(TagBuffer buf) const override
+    {
+        buf.WriteU8(m_data);
+        for (uint32_t i = 1; i < SIZE; ++i)
+        {
+            buf.WriteU8(N);
+        }
+    }
+
+    void Deserialize(TagBuffer buf) override
+    {
+        m_data = buf.ReadU8();
+        for (uint32_t i = 1; i < SIZE; ++i)
+        {
+            if (buf.ReadU8() != N)
+            {
+                m_error = true;
+            }
+        }
+    }
+
+    void Print(std::ostream& os) const override
+    {
+        os << "hot" << N << "(" << GetData() << ")";
+    }
+
+    AHotTestTag()
+        : ATestTagBase()
+    {
+    }
+
+    /// Constructor
+    /// \param data Tag data
+    AHotTestTag(uint8_t data)
+        : ATestTagBase(data)
+    {
+    }
+};
+
 // Previous versions of ns-3 limited the tag size to 20 bytes or less
 // static const uint8_t LARGE_TAG_BUFFER_SIZE = 64;
 #define LARGE_TAG_BUFFER_SIZE 64
@@ -1257,6 +1337,188 @@ PacketTagListTest::DoRun()
     } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet Tag list hot tag slots unit tests.
+ */
+class PacketTagListHotTagTest : public TestCase
+{
+  public:
+    PacketTagListHotTagTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketTagListHotTagTest::PacketTagListHotTagTest()
+    : TestCase("Check the hot tag slots of the PacketTagList")
+{
+}
+
+void
+PacketTagListHotTagTest::DoRun()
+{
+    using HotTag = AHotTestTag<1, 4>;
+    using OtherHotTag = AHotTestTag<2, PacketTagList::HOT_TAG_SIZE>;
+    using LargeHotTag = AHotTestTag<3, PacketTagList::HOT_TAG_SIZE + 1>;
+    NS_TEST_ASSERT_MSG_EQ(PacketTagList::RegisterHotTag(HotTag::GetTypeId()),
+                          true,
+                          "No free hot tag slot");
+    NS_TEST_ASSERT_MSG_EQ(PacketTagList::RegisterHotTag(OtherHotTag::GetTypeId()),
+                          true,
+                          "No free hot tag slot");
+    NS_TEST_ASSERT_MSG_EQ(PacketTagList::RegisterHotTag(LargeHotTag::GetTypeId()),
+                          true,
+                          "No free hot tag slot");
+
+    PacketTagList ref;
+    ref.Add(HotTag(1));
+    ref.Add(OtherHotTag(2));
+    ref.Add(ATestTag<1>(3));
+    ref.Add(LargeHotTag(4));
+
+    auto check = [this](const PacketTagList& ptl, ATestTagBase&& tag, int expected) {
+        bool found = ptl.Peek(tag);
+        NS_TEST_EXPECT_MSG_EQ(found, (expected != 0), "Peek " << tag.GetInstanceTypeId());
+        if (found)
+        {
+            NS_TEST_EXPECT_MSG_EQ(tag.GetData(), expected, "Peek " << tag.GetInstanceTypeId());
+            NS_TEST_EXPECT_MSG_EQ(tag.m_error, false, "Peek " << tag.GetInstanceTypeId());
+        }
+    };
+    check(ref, HotTag(), 1);
+    check(ref, OtherHotTag(), 2);
+    check(ref, ATestTag<1>(), 3);
+    check(ref, LargeHotTag(), 4);
+
+    // The large tag does not fit in its slot, and is stored in the list
+    // with the other tags
+    uint32_t listed = 0;
+    for (auto cur = ref.Head(); cur != nullptr; cur = cur->next)
+    {
+        listed++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(listed, 2, "Wrong number of tags in the list");
+
+    // The copies are independent
+    PacketTagList copy = ref;
+    HotTag replaced(5);
+    NS_TEST_EXPECT_MSG_EQ(copy.Replace(replaced), true, "Replace");
+    HotTag removed;
+    NS_TEST_EXPECT_MSG_EQ(copy.Remove(removed), true, "Remove");
+    NS_TEST_EXPECT_MSG_EQ(removed.GetData(), 5, "Remove");
+    NS_TEST_EXPECT_MSG_EQ(copy.Remove(removed), false, "Remove twice");
+    check(copy, HotTag(), 0);
+    check(ref, HotTag(), 1);
+    copy.Add(HotTag(6));
+    check(copy, HotTag(), 6);
+    copy = ref;
+    check(copy, HotTag(), 1);
+    copy.RemoveAll();
+    check(copy, OtherHotTag(), 0);
+    check(ref, OtherHotTag(), 2);
+
+    // Iteration, printing and serialization see the hot tags
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddPacketTag(HotTag(7));
+    p->AddPacketTag(ATestTag<1>(8));
+    uint32_t items = 0;
+    for (auto i = p->GetPacketTagIterator(); i.HasNext(); items++)
+    {
+        auto item = i.Next();
+        if (item.GetTypeId() == HotTag::GetTypeId())
+        {
+            HotTag tag;
+            item.GetTag(tag);
+            NS_TEST_EXPECT_MSG_EQ(tag.GetData(), 7, "Iterate");
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(items, 2, "Wrong number of iterated tags");
+    std::ostringstream oss;
+    p->PrintPacketTags(oss);
+    NS_TEST_EXPECT_MSG_NE(oss.str().find("hot1(7)"), std::string::npos, "Print");
+
+    std::vector<uint8_t> buffer(p->GetSerializedSize());
+    NS_TEST_ASSERT_MSG_EQ(p->Serialize(buffer.data(), buffer.size()), 1, "Serialize");
+    Ptr<Packet> q = Create<Packet>(buffer.data(), buffer.size(), true);
+    HotTag hot;
+    NS_TEST_EXPECT_MSG_EQ(q->PeekPacketTag(hot), true, "Deserialize");
+    NS_TEST_EXPECT_MSG_EQ(hot.GetData(), 7, "Deserialize");
+    ATestTag<1> other;
+    NS_TEST_EXPECT_MSG_EQ(q->PeekPacketTag(other), true, "Deserialize");
+    NS_TEST_EXPECT_MSG_EQ(other.GetData(), 8, "Deserialize");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PoolAllocator unit tests.
+ */
+class PoolAllocatorTest : public TestCase
+{
+  public:
+    PoolAllocatorTest();
+
+  private:
+    void DoRun() override;
+};
+
+PoolAllocatorTest::PoolAllocatorTest()
+    : TestCase("Check the reuse of the packet memory by the PoolAllocator")
+{
+}
+
+void
+PoolAllocatorTest::DoRun()
+{
+    // Start from empty pools, which the previous tests may have filled
+    PoolAllocator::Release();
+    PoolAllocator::ResetStats();
+    Ptr<Packet> p = Create<Packet>(100);
+    const std::size_t packetClass = (sizeof(Packet) - 1) / PoolAllocator::GRANULARITY;
+    const Packet* freed = PeekPointer(p);
+    p = nullptr;
+    p = Create<Packet>(100);
+    NS_TEST_EXPECT_MSG_EQ(PeekPointer(p), freed, "The freed packet is not reused");
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats(packetClass).hits, 1, "Wrong hits");
+
+    // Objects larger than the size classes are not pooled
+    uint64_t pooled = PoolAllocator::GetStats().pooled;
+    const std::size_t largeSize = PoolAllocator::GRANULARITY * PoolAllocator::SIZE_CLASSES + 1;
+    PoolAllocator::Deallocate(PoolAllocator::Allocate(largeSize), largeSize);
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats().pooled, pooled, "Large object pooled");
+
+    // A pool holds at most MAX_CACHED objects
+    std::vector<void*> objects;
+    for (std::size_t i = 0; i <= PoolAllocator::MAX_CACHED; ++i)
+    {
+        objects.push_back(PoolAllocator::Allocate(largeSize - 1));
+    }
+    for (auto object : objects)
+    {
+        PoolAllocator::Deallocate(object, largeSize - 1);
+    }
+    const std::size_t largestClass = PoolAllocator::SIZE_CLASSES - 1;
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats(largestClass).pooled,
+                          PoolAllocator::MAX_CACHED,
+                          "Pool not capped");
+    pooled = PoolAllocator::GetStats().pooled;
+
+    // Nothing is pooled when disabled
+    PoolAllocator::SetEnabled(false);
+    p = nullptr;
+    p = Create<Packet>(100);
+    PoolAllocator::SetEnabled(true);
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats(packetClass).hits, 1, "Hit when disabled");
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats().pooled, pooled, "Pooled when disabled");
+
+    PoolAllocator::Release();
+    NS_TEST_EXPECT_MSG_EQ(PoolAllocator::GetStats().pooled, 0, "Pools not released");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1274,6 +1536,8 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::Duration::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::Duration::QUICK);
+    AddTestCase(new PacketTagListHotTagTest, TestCase::Duration::QUICK);
+    AddTestCase(new PoolAllocatorTest, TestCase::Duration::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,215 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/drop-tail-queue.h"
+#include "ns3/ring-buffer.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBuffer unit tests.
+ */
+class RingBufferTestCase : public TestCase
+{
+  public:
+    RingBufferTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the elements of a ring buffer.
+     *
+     * \param [in] buffer The ring buffer.
+     * \param [in] expected The expected elements.
+     */
+    void CheckElements(const RingBuffer<int>& buffer, const std::vector<int>& expected);
+};
+
+RingBufferTestCase::RingBufferTestCase()
+    : TestCase("Check the insertions, erasures and iterators of the ring buffer")
+{
+}
+
+void
+RingBufferTestCase::CheckElements(const RingBuffer<int>& buffer, const std::vector<int>& expected)
+{
+    NS_TEST_ASSERT_MSG_EQ(buffer.size(), expected.size(), "Unexpected number of elements");
+    auto it = buffer.begin();
+    for (std::size_t i = 0; i < expected.size(); ++i, ++it)
+    {
+        NS_TEST_EXPECT_MSG_EQ(*it, expected[i], "Unexpected element " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ((it == buffer.end()), true, "Unexpected end of the elements");
+}
+
+void
+RingBufferTestCase::DoRun()
+{
+    RingBuffer<int> buffer;
+    NS_TEST_EXPECT_MSG_EQ(buffer.empty(), true, "A new buffer is empty");
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 0, "A new buffer allocates nothing");
+
+    // Wrap the elements around the end of the array, then make it grow
+    std::vector<int> expected;
+    for (int i = 0; i < 10; ++i)
+    {
+        buffer.push_back(i);
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        buffer.pop_front();
+    }
+    for (int i = 10; i < 20; ++i)
+    {
+        buffer.push_back(i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), RingBuffer<int>::MIN_CAPACITY, "No growth expected");
+    RingBuffer<int>::const_iterator first = buffer.begin();
+    RingBuffer<int>::const_iterator last = buffer.end() - 1;
+    for (int i = 20; i < 40; ++i)
+    {
+        buffer.push_back(i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 2 * RingBuffer<int>::MIN_CAPACITY, "Growth expected");
+    for (int i = 8; i < 40; ++i)
+    {
+        expected.push_back(i);
+    }
+    CheckElements(buffer, expected);
+
+    // The iterators survive the growth of the array and the FIFO operations
+    NS_TEST_EXPECT_MSG_EQ(*first, 8, "The iterator to the first element is invalid");
+    NS_TEST_EXPECT_MSG_EQ(*last, 19, "The iterator to the last element is invalid");
+    buffer.erase(buffer.begin());
+    buffer.insert(buffer.end(), 40);
+    expected.erase(expected.begin());
+    expected.push_back(40);
+    NS_TEST_EXPECT_MSG_EQ(*last, 19, "The iterator does not survive the FIFO operations");
+    NS_TEST_EXPECT_MSG_EQ(last - buffer.begin(), 10, "Unexpected distance between iterators");
+    NS_TEST_EXPECT_MSG_EQ((buffer.begin() < last), true, "Unexpected order of the iterators");
+
+    // Insert and erase at the front and in the middle
+    auto it = buffer.insert(buffer.begin(), -1);
+    expected.insert(expected.begin(), -1);
+    NS_TEST_EXPECT_MSG_EQ(*it, -1, "Unexpected element inserted at the front");
+    it = buffer.insert(buffer.begin() + 5, 100);
+    expected.insert(expected.begin() + 5, 100);
+    NS_TEST_EXPECT_MSG_EQ(*it, 100, "Unexpected element inserted in the middle");
+    CheckElements(buffer, expected);
+    it = buffer.erase(buffer.begin() + 3);
+    expected.erase(expected.begin() + 3);
+    NS_TEST_EXPECT_MSG_EQ(*it, expected[3], "Unexpected element after the erased one");
+    it = buffer.erase(buffer.end() - 1);
+    expected.pop_back();
+    NS_TEST_EXPECT_MSG_EQ((it == buffer.end()), true, "Unexpected iterator after the last one");
+    CheckElements(buffer, expected);
+
+    buffer.clear();
+    NS_TEST_EXPECT_MSG_EQ(buffer.empty(), true, "The buffer is not empty after clear()");
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 0, "The buffer holds an array after clear()");
+
+    // Insert before the first element of an empty buffer
+    buffer.insert(buffer.end(), 1);
+    buffer.insert(buffer.begin(), 0);
+    CheckElements(buffer, {0, 1});
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check a deep DropTailQueue, whose items are stored in a RingBuffer.
+ */
+class RingBufferQueueTestCase : public TestCase
+{
+  public:
+    RingBufferQueueTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+RingBufferQueueTestCase::RingBufferQueueTestCase()
+    : TestCase("Check a deep drop tail queue stored in a ring buffer")
+{
+}
+
+void
+RingBufferQueueTestCase::DoRun()
+{
+    static_assert(std::is_base_of_v<Queue<Packet, RingBuffer<Ptr<Packet>>>, DropTailQueue<Packet>>,
+                  "The items of a DropTailQueue are expected to be stored in a RingBuffer");
+    static_assert(std::is_base_of_v<Queue<Packet, std::list<Ptr<Packet>>>,
+                                    DropTailQueue<Packet, std::list<Ptr<Packet>>>>,
+                  "A DropTailQueue is expected to accept a std::list container");
+
+    // The variants storing their items in a std::list can be created by name
+    for (const std::string name : {"ns3::DropTailQueue<Packet,PacketList>",
+                                   "ns3::DropTailQueue<QueueDiscItem,QueueDiscItemList>"})
+    {
+        TypeId tid;
+        NS_TEST_EXPECT_MSG_EQ(TypeId::LookupByNameFailSafe(name, &tid),
+                              true,
+                              name << " is not registered");
+    }
+
+    const uint32_t nPackets = 1000;
+    Ptr<DropTailQueue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+    queue->SetAttribute("MaxSize", StringValue(std::to_string(nPackets) + "p"));
+
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < nPackets; ++i)
+    {
+        packets.push_back(Create<Packet>(i % 100));
+        NS_TEST_EXPECT_MSG_EQ(queue->Enqueue(packets.back()), true, "Packet " << i << " dropped");
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->Enqueue(Create<Packet>()), false, "The queue should be full");
+
+    // Alternate the operations which remove the head of the queue
+    for (uint32_t i = 0; i < nPackets; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(queue->Peek(), packets[i], "Unexpected head of the queue");
+        Ptr<Packet> packet = (i % 2 == 0) ? queue->Dequeue() : queue->Remove();
+        NS_TEST_EXPECT_MSG_EQ(packet, packets[i], "Unexpected packet " << i);
+        if (i % 3 == 0)
+        {
+            packets.push_back(Create<Packet>());
+            queue->Enqueue(packets.back());
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), packets.size() - nPackets, "Unexpected length");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetTotalDroppedPackets(), nPackets / 2 + 1, "Unexpected drops");
+    queue->Flush();
+    NS_TEST_EXPECT_MSG_EQ(queue->IsEmpty(), true, "The queue should be empty");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief RingBuffer TestSuite
+ */
+class RingBufferTestSuite : public TestSuite
+{
+  public:
+    RingBufferTestSuite()
+        : TestSuite("ring-buffer", Type::UNIT)
+    {
+        AddTestCase(new RingBufferTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new RingBufferQueueTestCase(), TestCase::Duration::QUICK);
+    }
+};
+
+static RingBufferTestSuite g_ringBufferTestSuite; //!< Static variable for test initialization
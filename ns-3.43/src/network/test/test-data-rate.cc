@@ -258,6 +258,54 @@ DataRateTestCase2::DoRun()
     MultiplicationDoubleTest("6Gb/s", 1.0 / 7.0, "857142857.14b/s");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test the integer conversion from DataRate to time, at the
+ * nanosecond resolution
+ */
+class DataRateTestCase3 : public DataRateTestCase
+{
+  public:
+    DataRateTestCase3();
+
+  private:
+    void DoRun() override;
+};
+
+DataRateTestCase3::DataRateTestCase3()
+    : DataRateTestCase("Test integer conversion from DataRate to time")
+{
+}
+
+void
+DataRateTestCase3::DoRun()
+{
+    if (Time::GetResolution() != Time::NS)
+    {
+        Time::SetResolution(Time::NS);
+    }
+    // Same results as the int64x64_t division, unless exactly halfway
+    for (std::string rate : {"56kb/s", "1Mb/s", "1.5Mb/s", "10Mb/s", "1Gb/s", "3Gb/s", "100Gb/s"})
+    {
+        DataRate dr(rate);
+        for (uint32_t nBytes = 0; nBytes <= 1500; nBytes++)
+        {
+            CheckTimesEqual(dr.CalculateBytesTxTime(nBytes),
+                            Seconds(int64x64_t(nBytes * 8) / dr.GetBitRate()),
+                            "CalculateBytesTxTime returned incorrect value");
+        }
+    }
+    // 62.5ns, rounded away from zero
+    CheckTimesEqual(DataRate("128Mb/s").CalculateBitsTxTime(8),
+                    NanoSeconds(63),
+                    "CalculateBitsTxTime returned incorrect value");
+    CheckTimesEqual(DataRate("3b/s").CalculateBitsTxTime(2),
+                    NanoSeconds(666666667),
+                    "CalculateBitsTxTime returned incorrect value");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -273,6 +321,8 @@ class DataRateTestSuite : public TestSuite
 DataRateTestSuite::DataRateTestSuite()
     : TestSuite("data-rate", Type::UNIT)
 {
+    // This should be first, since the others change the resolution
+    AddTestCase(new DataRateTestCase3(), TestCase::Duration::QUICK);
     AddTestCase(new DataRateTestCase1(), TestCase::Duration::QUICK);
     AddTestCase(new DataRateTestCase2(), TestCase::Duration::QUICK);
 }
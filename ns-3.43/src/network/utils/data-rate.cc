@@ -11,6 +11,7 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
+#include "ns3/time-ticks.h"
 
 namespace ns3
 {
@@ -227,6 +228,12 @@ Time
 DataRate::CalculateBitsTxTime(uint32_t bits) const
 {
     NS_LOG_FUNCTION(this << bits);
+    if (NanoTicks::IsResolution())
+    {
+        // Integer arithmetic, rather than an int64x64_t division and a
+        // conversion from seconds
+        return NanoTicks::FromRatio(bits, m_bps).ToTime();
+    }
     return Seconds(int64x64_t(bits) / m_bps);
 }
 
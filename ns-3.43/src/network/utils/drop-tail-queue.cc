@@ -13,5 +13,7 @@ NS_LOG_COMPONENT_DEFINE("DropTailQueue");
 
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(DropTailQueue, Packet);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(DropTailQueue, QueueDiscItem);
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(DropTailQueue, Packet, PacketList);
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(DropTailQueue, QueueDiscItem, QueueDiscItemList);
 
 } // namespace ns3
@@ -16,9 +16,13 @@ namespace ns3
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * \tparam Item \explicit Type of the objects stored within the queue
+ * \tparam Container \explicit Type of the container that stores queue items,
+ *         a RingBuffer by default (see Queue)
  */
-template <typename Item>
-class DropTailQueue : public Queue<Item>
+template <typename Item, typename Container = RingBuffer<Ptr<Item>>>
+class DropTailQueue : public Queue<Item, Container>
 {
   public:
     /**
@@ -41,11 +45,11 @@ class DropTailQueue : public Queue<Item>
     Ptr<const Item> Peek() const override;
 
   private:
-    using Queue<Item>::GetContainer;
-    using Queue<Item>::DoEnqueue;
-    using Queue<Item>::DoDequeue;
-    using Queue<Item>::DoRemove;
-    using Queue<Item>::DoPeek;
+    using Queue<Item, Container>::GetContainer;
+    using Queue<Item, Container>::DoEnqueue;
+    using Queue<Item, Container>::DoDequeue;
+    using Queue<Item, Container>::DoRemove;
+    using Queue<Item, Container>::DoPeek;
 
     NS_LOG_TEMPLATE_DECLARE; //!< redefinition of the log component
 };
@@ -54,15 +58,15 @@ class DropTailQueue : public Queue<Item>
  * Implementation of the templates declared above.
  */
 
-template <typename Item>
+template <typename Item, typename Container>
 TypeId
-DropTailQueue<Item>::GetTypeId()
+DropTailQueue<Item, Container>::GetTypeId()
 {
     static TypeId tid =
-        TypeId(GetTemplateClassName<DropTailQueue<Item>>())
-            .SetParent<Queue<Item>>()
+        TypeId(GetTemplateClassName<DropTailQueue<Item, Container>>())
+            .SetParent<Queue<Item, Container>>()
             .SetGroupName("Network")
-            .template AddConstructor<DropTailQueue<Item>>()
+            .template AddConstructor<DropTailQueue<Item, Container>>()
             .AddAttribute("MaxSize",
                           "The max queue size",
                           QueueSizeValue(QueueSize("100p")),
@@ -71,32 +75,32 @@ DropTailQueue<Item>::GetTypeId()
     return tid;
 }
 
-template <typename Item>
-DropTailQueue<Item>::DropTailQueue()
-    : Queue<Item>(),
+template <typename Item, typename Container>
+DropTailQueue<Item, Container>::DropTailQueue()
+    : Queue<Item, Container>(),
       NS_LOG_TEMPLATE_DEFINE("DropTailQueue")
 {
     NS_LOG_FUNCTION(this);
 }
 
-template <typename Item>
-DropTailQueue<Item>::~DropTailQueue()
+template <typename Item, typename Container>
+DropTailQueue<Item, Container>::~DropTailQueue()
 {
     NS_LOG_FUNCTION(this);
 }
 
-template <typename Item>
+template <typename Item, typename Container>
 bool
-DropTailQueue<Item>::Enqueue(Ptr<Item> item)
+DropTailQueue<Item, Container>::Enqueue(Ptr<Item> item)
 {
     NS_LOG_FUNCTION(this << item);
 
     return DoEnqueue(GetContainer().end(), item);
 }
 
-template <typename Item>
+template <typename Item, typename Container>
 Ptr<Item>
-DropTailQueue<Item>::Dequeue()
+DropTailQueue<Item, Container>::Dequeue()
 {
     NS_LOG_FUNCTION(this);
 
@@ -107,9 +111,9 @@ DropTailQueue<Item>::Dequeue()
     return item;
 }
 
-template <typename Item>
+template <typename Item, typename Container>
 Ptr<Item>
-DropTailQueue<Item>::Remove()
+DropTailQueue<Item, Container>::Remove()
 {
     NS_LOG_FUNCTION(this);
 
@@ -120,9 +124,9 @@ DropTailQueue<Item>::Remove()
     return item;
 }
 
-template <typename Item>
+template <typename Item, typename Container>
 Ptr<const Item>
-DropTailQueue<Item>::Peek() const
+DropTailQueue<Item, Container>::Peek() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -131,13 +135,18 @@ DropTailQueue<Item>::Peek() const
 
 // The following explicit template instantiation declarations prevent all the
 // translation units including this header file to implicitly instantiate the
-// DropTailQueue<Packet> class and the DropTailQueue<QueueDiscItem> class. The
-// unique instances of these classes are explicitly created through the macros
-// NS_OBJECT_TEMPLATE_CLASS_DEFINE (DropTailQueue,Packet) and
-// NS_OBJECT_TEMPLATE_CLASS_DEFINE (DropTailQueue,QueueDiscItem), which are included
-// in drop-tail-queue.cc
+// DropTailQueue<Packet> class and the DropTailQueue<QueueDiscItem> class, as
+// well as their variants storing items in a std::list. The unique instances of
+// these classes are explicitly created through the macros
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (DropTailQueue,Packet),
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (DropTailQueue,QueueDiscItem),
+// NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE (DropTailQueue,Packet,PacketList) and
+// NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE (DropTailQueue,QueueDiscItem,QueueDiscItemList),
+// which are included in drop-tail-queue.cc
 extern template class DropTailQueue<Packet>;
 extern template class DropTailQueue<QueueDiscItem>;
+extern template class DropTailQueue<Packet, PacketList>;
+extern template class DropTailQueue<QueueDiscItem, QueueDiscItemList>;
 
 } // namespace ns3
 
@@ -10,6 +10,7 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/pool-allocator.h"
 
 namespace ns3
 {
@@ -28,6 +29,18 @@ QueueItem::~QueueItem()
     m_packet = nullptr;
 }
 
+void*
+QueueItem::operator new(std::size_t size)
+{
+    return PoolAllocator::Allocate(size);
+}
+
+void
+QueueItem::operator delete(void* ptr, std::size_t size)
+{
+    PoolAllocator::Deallocate(ptr, size);
+}
+
 Ptr<Packet>
 QueueItem::GetPacket() const
 {
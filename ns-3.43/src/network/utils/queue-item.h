@@ -43,6 +43,19 @@ class QueueItem : public SimpleRefCount<QueueItem>
 
     virtual ~QueueItem();
 
+    /**
+     * \brief Allocate a queue item, of any subclass, from the PoolAllocator.
+     * \param size the size of the queue item.
+     * \return the memory of the queue item.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Return the memory of a queue item to the PoolAllocator.
+     * \param ptr the memory of the queue item.
+     * \param size the size of the queue item.
+     */
+    static void operator delete(void* ptr, std::size_t size);
+
     // Delete default constructor, copy constructor and assignment operator to avoid misuse
     QueueItem() = delete;
     QueueItem(const QueueItem&) = delete;
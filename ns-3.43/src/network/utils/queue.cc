@@ -19,6 +19,8 @@ NS_LOG_COMPONENT_DEFINE("Queue");
 NS_OBJECT_ENSURE_REGISTERED(QueueBase);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(Queue, Packet);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(Queue, QueueDiscItem);
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(Queue, Packet, PacketList);
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(Queue, QueueDiscItem, QueueDiscItemList);
 
 TypeId
 QueueBase::GetTypeId()
@@ -14,6 +14,7 @@
 #include "queue-fwd.h"
 #include "queue-item.h"
 #include "queue-size.h"
+#include "ring-buffer.h"
 
 #include "ns3/log.h"
 #include "ns3/object.h"
@@ -21,6 +22,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <list>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -235,7 +237,10 @@ class QueueBase : public Object
  * container used internally to store queue items. The container type must provide
  * the methods insert(), erase() and clear() and define the iterator and const_iterator
  * types, following the usual syntax of C++ containers. The default container type
- * is std::list (as defined in queue-fwd.h). In case the container is such that
+ * is RingBuffer (as defined in queue-fwd.h), whose iterators remain valid when
+ * items are inserted at either end or removed from the head; a subclass which
+ * keeps iterators across insertions or removals in the middle of the queue must
+ * use a container such as std::list. In case the container is such that
  * an object stored within the queue is obtained from a container element through
  * an operation other than dereferencing an iterator pointing to the container
  * element, the container has to provide a public method named GetItem that
@@ -659,14 +664,27 @@ Queue<Item, Container>::DropAfterDequeue(Ptr<Item> item)
     m_traceDropAfterDequeue(item);
 }
 
+/// A std::list of packets, for the queues whose iterators have to remain valid
+/// across insertions and removals in the middle of the queue
+using PacketList = std::list<Ptr<Packet>>;
+/// A std::list of queue disc items, for the queues whose iterators have to remain
+/// valid across insertions and removals in the middle of the queue
+using QueueDiscItemList = std::list<Ptr<QueueDiscItem>>;
+
 // The following explicit template instantiation declarations prevent all the
 // translation units including this header file to implicitly instantiate the
-// Queue<Packet> class and the Queue<QueueDiscItem> class. The unique instances
-// of these classes are explicitly created through the macros
-// NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue,Packet) and
-// NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue,QueueDiscItem), which are included in queue.cc
+// Queue<Packet> class and the Queue<QueueDiscItem> class, as well as their
+// variants storing items in a std::list. The unique instances of these classes
+// are explicitly created through the macros
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue,Packet),
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue,QueueDiscItem),
+// NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE (Queue,Packet,PacketList) and
+// NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE (Queue,QueueDiscItem,QueueDiscItemList), which are
+// included in queue.cc
 extern template class Queue<Packet>;
 extern template class Queue<QueueDiscItem>;
+extern template class Queue<Packet, PacketList>;
+extern template class Queue<QueueDiscItem, QueueDiscItemList>;
 
 } // namespace ns3
 
@@ -0,0 +1,508 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup queue
+ * ns3::RingBuffer declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief A growable circular buffer, the default container of the Queue class
+ *
+ * The elements are stored contiguously in an array whose size is a power of
+ * two, from a head position to a tail position which wrap around the end of
+ * the array.  Inserting an element at either end and erasing the first or the
+ * last element take constant time and, unlike std::list, allocate nothing,
+ * except when the array is full: it is then replaced by an array twice as
+ * large.  The array is only released by clear(), so that a queue which has
+ * been deep once does not allocate again.  Inserting or erasing an element
+ * elsewhere moves the elements which follow it.
+ *
+ * An iterator refers to an element by its position since the creation of the
+ * buffer, rather than by its place in the array.  Hence, the iterators to the
+ * other elements remain valid when an element is inserted at either end, even
+ * if the array grows, and when the first or the last element is erased, which
+ * are all the operations of a FIFO queue.  Any other insert() or erase()
+ * invalidates the iterators to the elements which follow the position.
+ *
+ * \tparam T \explicit The type of the elements, which must be default
+ *           constructible and move assignable (e.g., Ptr<Packet>).
+ */
+template <typename T>
+class RingBuffer
+{
+  private:
+    /**
+     * Iterator over the elements of a RingBuffer.
+     *
+     * \tparam Const Whether the elements are constant.
+     */
+    template <bool Const>
+    class IteratorImpl
+    {
+      public:
+        /// The type of the buffer
+        using Buffer = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+
+        using iterator_category = std::random_access_iterator_tag; //!< The category
+        using value_type = T;                                      //!< The value type
+        using difference_type = std::ptrdiff_t;                    //!< The difference type
+        using pointer = std::conditional_t<Const, const T*, T*>;   //!< The pointer type
+        using reference = std::conditional_t<Const, const T&, T&>; //!< The reference type
+
+        /** Construct a singular iterator. */
+        IteratorImpl() = default;
+
+        /**
+         * Construct an iterator.
+         *
+         * \param [in] buffer The buffer.
+         * \param [in] pos The position of the element.
+         */
+        IteratorImpl(Buffer* buffer, std::size_t pos)
+            : m_buffer(buffer),
+              m_pos(pos)
+        {
+        }
+
+        /**
+         * Convert an iterator into a const iterator.
+         *
+         * \param [in] other The iterator.
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorImpl(const IteratorImpl<false>& other)
+            : m_buffer(other.m_buffer),
+              m_pos(other.m_pos)
+        {
+        }
+
+        /** \returns The element. */
+        reference operator*() const
+        {
+            return m_buffer->Slot(m_pos);
+        }
+
+        /** \returns A pointer to the element. */
+        pointer operator->() const
+        {
+            return &m_buffer->Slot(m_pos);
+        }
+
+        /**
+         * \param [in] n The offset.
+         * \returns The element \pname{n} positions after this one.
+         */
+        reference operator[](difference_type n) const
+        {
+            return m_buffer->Slot(m_pos + n);
+        }
+
+        /** \returns This iterator, moved to the next element. */
+        IteratorImpl& operator++()
+        {
+            ++m_pos;
+            return *this;
+        }
+
+        /** \returns This iterator, before it is moved to the next element. */
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl it = *this;
+            ++m_pos;
+            return it;
+        }
+
+        /** \returns This iterator, moved to the previous element. */
+        IteratorImpl& operator--()
+        {
+            --m_pos;
+            return *this;
+        }
+
+        /** \returns This iterator, before it is moved to the previous element. */
+        IteratorImpl operator--(int)
+        {
+            IteratorImpl it = *this;
+            --m_pos;
+            return it;
+        }
+
+        /**
+         * \param [in] n The offset.
+         * \returns This iterator, moved \pname{n} elements forward.
+         */
+        IteratorImpl& operator+=(difference_type n)
+        {
+            m_pos += n;
+            return *this;
+        }
+
+        /**
+         * \param [in] n The offset.
+         * \returns This iterator, moved \pname{n} elements backward.
+         */
+        IteratorImpl& operator-=(difference_type n)
+        {
+            m_pos -= n;
+            return *this;
+        }
+
+        /**
+         * \param [in] it The iterator.
+         * \param [in] n The offset.
+         * \returns An iterator \pname{n} elements after \pname{it}.
+         */
+        friend IteratorImpl operator+(IteratorImpl it, difference_type n)
+        {
+            return it += n;
+        }
+
+        /**
+         * \param [in] n The offset.
+         * \param [in] it The iterator.
+         * \returns An iterator \pname{n} elements after \pname{it}.
+         */
+        friend IteratorImpl operator+(difference_type n, IteratorImpl it)
+        {
+            return it += n;
+        }
+
+        /**
+         * \param [in] it The iterator.
+         * \param [in] n The offset.
+         * \returns An iterator \pname{n} elements before \pname{it}.
+         */
+        friend IteratorImpl operator-(IteratorImpl it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns The number of elements from \pname{b} to \pname{a}.
+         */
+        friend difference_type operator-(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return static_cast<difference_type>(a.m_pos - b.m_pos);
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} and \pname{b} refer to the same element.
+         */
+        friend bool operator==(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.m_pos == b.m_pos;
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} and \pname{b} refer to different elements.
+         */
+        friend bool operator!=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.m_pos != b.m_pos;
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} refers to an element before \pname{b}.
+         */
+        friend bool operator<(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a - b < 0;
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} refers to an element after \pname{b}.
+         */
+        friend bool operator>(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return b < a;
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} does not refer to an element after \pname{b}.
+         */
+        friend bool operator<=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(b < a);
+        }
+
+        /**
+         * \param [in] a An iterator.
+         * \param [in] b An iterator into the same buffer.
+         * \returns Whether \pname{a} does not refer to an element before \pname{b}.
+         */
+        friend bool operator>=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(a < b);
+        }
+
+      private:
+        friend class RingBuffer;
+        friend class IteratorImpl<!Const>;
+
+        Buffer* m_buffer{nullptr}; //!< The buffer
+        std::size_t m_pos{0};      //!< The position of the element
+    };
+
+  public:
+    using value_type = T;                      //!< The value type
+    using size_type = std::size_t;             //!< The size type
+    using difference_type = std::ptrdiff_t;    //!< The difference type
+    using reference = T&;                      //!< The reference type
+    using const_reference = const T&;          //!< The const reference type
+    using iterator = IteratorImpl<false>;      //!< The iterator type
+    using const_iterator = IteratorImpl<true>; //!< The const iterator type
+
+    /** The capacity of the array allocated for the first element. */
+    static constexpr size_type MIN_CAPACITY = 16;
+
+    /** \returns An iterator to the first element. */
+    iterator begin()
+    {
+        return iterator(this, m_head);
+    }
+
+    /** \returns A const iterator to the first element. */
+    const_iterator begin() const
+    {
+        return const_iterator(this, m_head);
+    }
+
+    /** \returns An iterator past the last element. */
+    iterator end()
+    {
+        return iterator(this, m_tail);
+    }
+
+    /** \returns A const iterator past the last element. */
+    const_iterator end() const
+    {
+        return const_iterator(this, m_tail);
+    }
+
+    /** \returns The number of elements. */
+    size_type size() const
+    {
+        return m_tail - m_head;
+    }
+
+    /** \returns Whether there is no element. */
+    bool empty() const
+    {
+        return m_tail == m_head;
+    }
+
+    /** \returns The number of elements which can be stored before the array grows. */
+    size_type capacity() const
+    {
+        return m_slots.size();
+    }
+
+    /** \returns The first element. */
+    reference front()
+    {
+        NS_ASSERT(!empty());
+        return Slot(m_head);
+    }
+
+    /** \returns The first element. */
+    const_reference front() const
+    {
+        NS_ASSERT(!empty());
+        return Slot(m_head);
+    }
+
+    /** \returns The last element. */
+    reference back()
+    {
+        NS_ASSERT(!empty());
+        return Slot(m_tail - 1);
+    }
+
+    /** \returns The last element. */
+    const_reference back() const
+    {
+        NS_ASSERT(!empty());
+        return Slot(m_tail - 1);
+    }
+
+    /**
+     * Insert an element after the last one.
+     *
+     * \param [in] value The element.
+     */
+    void push_back(T value)
+    {
+        Reserve(size() + 1);
+        Slot(m_tail++) = std::move(value);
+    }
+
+    /**
+     * Insert an element before the first one.
+     *
+     * \param [in] value The element.
+     */
+    void push_front(T value)
+    {
+        Reserve(size() + 1);
+        Slot(--m_head) = std::move(value);
+    }
+
+    /** Erase the first element. */
+    void pop_front()
+    {
+        NS_ASSERT(!empty());
+        Slot(m_head++) = T();
+    }
+
+    /** Erase the last element. */
+    void pop_back()
+    {
+        NS_ASSERT(!empty());
+        Slot(--m_tail) = T();
+    }
+
+    /**
+     * Insert an element.
+     *
+     * \param [in] pos The element before which to insert.
+     * \param [in] value The element to insert.
+     * \returns An iterator to the inserted element.
+     */
+    iterator insert(const_iterator pos, T value)
+    {
+        NS_ASSERT(pos.m_buffer == this && pos.m_pos - m_head <= size());
+        if (pos.m_pos == m_tail)
+        {
+            push_back(std::move(value));
+            return iterator(this, m_tail - 1);
+        }
+        if (pos.m_pos == m_head)
+        {
+            push_front(std::move(value));
+            return begin();
+        }
+        std::size_t p = pos.m_pos;
+        Reserve(size() + 1);
+        for (std::size_t i = m_tail; i != p; --i)
+        {
+            Slot(i) = std::move(Slot(i - 1));
+        }
+        Slot(p) = std::move(value);
+        ++m_tail;
+        return iterator(this, p);
+    }
+
+    /**
+     * Erase an element.
+     *
+     * \param [in] pos The element to erase.
+     * \returns An iterator to the element which followed the erased one.
+     */
+    iterator erase(const_iterator pos)
+    {
+        NS_ASSERT(pos.m_buffer == this && pos.m_pos - m_head < size());
+        if (pos.m_pos == m_head)
+        {
+            pop_front();
+            return begin();
+        }
+        for (std::size_t i = pos.m_pos; i + 1 != m_tail; ++i)
+        {
+            Slot(i) = std::move(Slot(i + 1));
+        }
+        pop_back();
+        return iterator(this, pos.m_pos);
+    }
+
+    /** Erase all the elements and release the array. */
+    void clear()
+    {
+        std::vector<T>().swap(m_slots);
+        m_head = 0;
+        m_tail = 0;
+    }
+
+  private:
+    /**
+     * \param [in] pos The position of an element.
+     * \returns The slot of the array holding the element.
+     */
+    T& Slot(std::size_t pos)
+    {
+        return m_slots[pos & (m_slots.size() - 1)];
+    }
+
+    /**
+     * \param [in] pos The position of an element.
+     * \returns The slot of the array holding the element.
+     */
+    const T& Slot(std::size_t pos) const
+    {
+        return m_slots[pos & (m_slots.size() - 1)];
+    }
+
+    /**
+     * Grow the array, if needed, so that it can hold the given number of
+     * elements.  Each element keeps its position, hence the iterators remain
+     * valid.
+     *
+     * \param [in] n The number of elements.
+     */
+    void Reserve(size_type n)
+    {
+        if (n <= m_slots.size())
+        {
+            return;
+        }
+        size_type capacity = m_slots.empty() ? MIN_CAPACITY : 2 * m_slots.size();
+        while (capacity < n)
+        {
+            capacity *= 2;
+        }
+        std::vector<T> slots(capacity);
+        for (std::size_t pos = m_head; pos != m_tail; ++pos)
+        {
+            slots[pos & (capacity - 1)] = std::move(Slot(pos));
+        }
+        m_slots.swap(slots);
+    }
+
+    std::vector<T> m_slots; //!< The array, whose size is zero or a power of two
+    std::size_t m_head{0};  //!< The position of the first element
+    std::size_t m_tail{0};  //!< The position past the last element
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
@@ -85,11 +85,15 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+    // Hand the packet itself over to the receiver, which modifies it, unless
+    // a trace sink of the source or of this channel may keep it
+    bool copy = src->NeedsTxPacketCopy() || !m_txrxPointToPoint.IsEmpty();
+    Ptr<Packet> rx = copy ? p->Copy() : ConstCast<Packet>(p);
     Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
                                    m_link[wire].m_dst,
-                                   p->Copy());
+                                   rx);
 
     // Call the tx anim callback on the net device
     m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
@@ -63,6 +63,11 @@ class PointToPointChannel : public Channel
 
     /**
      * \brief Transmit a packet over this channel
+     *
+     * The packet is handed over to the destination device without a copy,
+     * unless PointToPointNetDevice::NeedsTxPacketCopy returns true for the
+     * source or a sink is connected to the TxRxPointToPoint trace.
+     *
      * \param p Packet to transmit
      * \param src Source PointToPointNetDevice
      * \param txTime Transmit time to apply
@@ -252,6 +252,13 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     return result;
 }
 
+bool
+PointToPointNetDevice::NeedsTxPacketCopy() const
+{
+    return !m_macTxTrace.IsEmpty() || !m_phyTxBeginTrace.IsEmpty() || !m_phyTxEndTrace.IsEmpty() ||
+           !m_snifferTrace.IsEmpty() || !m_promiscSnifferTrace.IsEmpty();
+}
+
 void
 PointToPointNetDevice::TransmitComplete()
 {
@@ -345,9 +352,13 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
 
         //
         // Trace sinks will expect complete packets, not packets without some of the
-        // headers.
+        // headers.  The copy is only made when there are such sinks.
         //
-        Ptr<Packet> originalPacket = packet->Copy();
+        Ptr<Packet> originalPacket;
+        if (!m_macRxTrace.IsEmpty() || !m_macPromiscRxTrace.IsEmpty())
+        {
+            originalPacket = packet->Copy();
+        }
 
         //
         // Strip off the point-to-point protocol header and forward this packet
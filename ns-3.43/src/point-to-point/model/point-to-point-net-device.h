@@ -143,6 +143,20 @@ class PointToPointNetDevice : public NetDevice
      */
     void Receive(Ptr<Packet> p);
 
+    /**
+     * Whether this device still needs the packet it is transmitting once
+     * handed over to the channel.
+     *
+     * A sink connected to the MacTx, PhyTxBegin, PhyTxEnd, Sniffer or
+     * PromiscSniffer trace may keep the packet and look at it later.  When
+     * no sink is connected to any of them, the channel hands the packet
+     * itself over to the receiving device, which strips its headers, rather
+     * than a copy of it.
+     *
+     * \returns true if the channel has to hand a copy of the packet over.
+     */
+    bool NeedsTxPacketCopy() const;
+
     // The remaining methods are documented in ns3::NetDevice*
 
     void SetIfIndex(const uint32_t index) override;
@@ -128,6 +128,130 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test the hand-off of the transmitted packet to the receiver
+ *
+ * The channel hands the packet itself over to the receiving device when
+ * no sender-side trace sink may keep it, and a copy of it otherwise, so that
+ * the packets kept by the trace sinks are not modified by the receiver.
+ */
+class PointToPointHandOffTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointHandOffTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send one packet from a device to another
+     *
+     * \param txTrace The sender-side trace source whose sink keeps the
+     *        packet, either of the sending device or TxRxPointToPoint of the
+     *        channel, or an empty string for none.
+     */
+    void SendOnePacket(const std::string& txTrace);
+
+    Ptr<Packet> m_sentPacket;        //!< sent packet
+    Ptr<const Packet> m_recvdPacket; //!< received packet
+    Ptr<const Packet> m_txPacket;    //!< packet kept by the sender-side trace sink
+    uint32_t m_macRxSize;            //!< size of the packet at MacRx
+};
+
+PointToPointHandOffTest::PointToPointHandOffTest()
+    : TestCase("PointToPoint hand-off of the transmitted packet")
+{
+}
+
+void
+PointToPointHandOffTest::SendOnePacket(const std::string& txTrace)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    m_recvdPacket = nullptr;
+    m_txPacket = nullptr;
+    m_macRxSize = 0;
+    devB->SetReceiveCallback(NetDevice::ReceiveCallback(
+        [this](Ptr<NetDevice>, Ptr<const Packet> pkt, uint16_t, const Address&) {
+            m_recvdPacket = pkt;
+            return true;
+        }));
+    if (txTrace == "TxRxPointToPoint")
+    {
+        channel->TraceConnectWithoutContext(
+            txTrace,
+            Callback<void, Ptr<const Packet>, Ptr<NetDevice>, Ptr<NetDevice>, Time, Time>(
+                [this](Ptr<const Packet> pkt, Ptr<NetDevice>, Ptr<NetDevice>, Time, Time) {
+                    m_txPacket = pkt;
+                }));
+    }
+    else if (!txTrace.empty())
+    {
+        devA->TraceConnectWithoutContext(
+            txTrace,
+            Callback<void, Ptr<const Packet>>([this](Ptr<const Packet> pkt) { m_txPacket = pkt; }));
+    }
+    devB->TraceConnectWithoutContext(
+        "MacRx",
+        Callback<void, Ptr<const Packet>>(
+            [this](Ptr<const Packet> pkt) { m_macRxSize = pkt->GetSize(); }));
+    NS_TEST_EXPECT_MSG_EQ(devA->NeedsTxPacketCopy(),
+                          !txTrace.empty() && txTrace != "TxRxPointToPoint",
+                          "Unexpected copy need with a " << txTrace << " sink");
+
+    m_sentPacket = Create<Packet>(100);
+    devA->Send(m_sentPacket, devA->GetBroadcast(), 0x800);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+PointToPointHandOffTest::DoRun()
+{
+    SendOnePacket("");
+    NS_TEST_ASSERT_MSG_NE(m_recvdPacket, nullptr, "Not received");
+    NS_TEST_EXPECT_MSG_EQ(m_recvdPacket->GetSize(), 100, "Wrong size");
+    NS_TEST_EXPECT_MSG_EQ(PeekPointer(m_recvdPacket),
+                          PeekPointer(m_sentPacket),
+                          "The packet is not handed over");
+
+    for (const std::string txTrace :
+         {"MacTx", "PhyTxBegin", "PhyTxEnd", "Sniffer", "PromiscSniffer", "TxRxPointToPoint"})
+    {
+        SendOnePacket(txTrace);
+        NS_TEST_ASSERT_MSG_NE(m_recvdPacket, nullptr, "Not received with a " << txTrace << " sink");
+        NS_TEST_EXPECT_MSG_EQ(m_recvdPacket->GetSize(), 100, "Wrong size");
+        NS_TEST_EXPECT_MSG_NE(PeekPointer(m_recvdPacket),
+                              PeekPointer(m_sentPacket),
+                              "A copy is not handed over with a " << txTrace << " sink");
+        // The packet kept by the sink still has the 2 bytes point-to-point
+        // header after the reception
+        NS_TEST_ASSERT_MSG_NE(m_txPacket, nullptr, "Not traced by " << txTrace);
+        NS_TEST_EXPECT_MSG_EQ(m_txPacket->GetSize(), 102, txTrace << " keeps a modified packet");
+        NS_TEST_EXPECT_MSG_EQ(m_macRxSize, 102, "MacRx sees a modified packet");
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -144,6 +268,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", Type::UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointHandOffTest, TestCase::Duration::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -1,527 +1,905 @@
- #include "canlendar-queue-disc.h"
- #include "ns3/log.h"
- #include "ns3/packet.h"
- #include "ns3/simulator.h"
- #include "ns3/log.h"
- #include "ns3/object-factory.h"
- #include "ns3/pointer.h"
- #include "ns3/socket.h"
- #include <algorithm>
- #include <iterator>
- #include "ns3/prio-queue-disc.h"
- #include "ns3/tags.h"
-#include "ns3/udp-header.h"
+#include "canlendar-queue-disc.h"
+
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/packet-tag-list.h"
+#include "ns3/packet.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/simulator.h"
+#include "ns3/tags.h"
+#include "ns3/time-ticks.h"
 #include "ns3/timestamp-tag.h"
- namespace ns3
- {
- 
- NS_LOG_COMPONENT_DEFINE("CanlendarQueueDisc");
- 
- NS_OBJECT_ENSURE_REGISTERED(CanlendarQueueDisc);
- 
-//  ATTRIBUTE_HELPER_CPP(Priomap);
- 
-//  std::ostream&
-//  operator<<(std::ostream& os, const Priomap& priomap)
-//  {
-//      std::copy(priomap.begin(), priomap.end() - 1, std::ostream_iterator<uint16_t>(os, " "));
-//      os << priomap.back();
-//      return os;
-//  }
- 
-//  std::istream&
-//  operator>>(std::istream& is, Priomap& priomap)
-//  {
-//      for (int i = 0; i < 16; i++)
-//      {
-//          if (!(is >> priomap[i]))
-//          {
-//              NS_FATAL_ERROR("Incomplete priomap specification ("
-//                             << i << " values provided, 16 required)");
-//          }
-//      }
-//      return is;
-//  }
- 
- TypeId
- CanlendarQueueDisc::GetTypeId()
- {
-     static TypeId tid =
-         TypeId("ns3::CanlendarQueueDisc")
-             .SetParent<QueueDisc>()
-             .SetGroupName("TrafficControl")
-             .AddConstructor<CanlendarQueueDisc>()
-             .AddAttribute("Priomap",
-                           "The priority to band mapping.",
-                           PriomapValue(Priomap{{1, 2, 2, 2, 1, 2, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1}}),
-                           MakePriomapAccessor(&CanlendarQueueDisc::m_prio2band),
-                           MakePriomapChecker())
-             .AddAttribute("RotationInterval",
-                            "Time interval for priority rotation",
-                            TimeValue(Seconds(1.0)),  // 默认 1.0s
-                            MakeTimeAccessor(&CanlendarQueueDisc::m_rotationInterval),
-                            MakeTimeChecker())
-             .AddAttribute ("MaxSize",
-                            "The maximum number of packets or bytes the queue can hold.",
-                            QueueSizeValue(QueueSize(QueueSizeUnit::BYTES, 512*10e6)),
-                            MakeQueueSizeAccessor (&CanlendarQueueDisc::SetMaxSize,
-                                                    &CanlendarQueueDisc::GetMaxSize),
-                            MakeQueueSizeChecker ());               
-     return tid;
- }
-
- CanlendarQueueDisc::CanlendarQueueDisc()
-     : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES)
- {
-     NS_LOG_FUNCTION(this);
- }
- 
- CanlendarQueueDisc::~CanlendarQueueDisc()
- {
-     NS_LOG_FUNCTION(this);
- }
- 
- void
+#include "ns3/traffic-control-layer.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CanlendarQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(CanlendarQueueDisc);
+
+TypeId
+CanlendarQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CanlendarQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<CanlendarQueueDisc>()
+            .AddAttribute("Priomap",
+                          "The priority to band mapping.",
+                          PriomapValue(Priomap{{1, 2, 2, 2, 1, 2, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1}}),
+                          MakePriomapAccessor(&CanlendarQueueDisc::m_prio2band),
+                          MakePriomapChecker())
+            .AddAttribute("RotationInterval",
+                          "Time interval for priority rotation",
+                          TimeValue(Seconds(1.0)), // 默认 1.0s
+                          MakeTimeAccessor(&CanlendarQueueDisc::m_rotationInterval),
+                          MakeTimeChecker())
+            .AddAttribute("NumSlots",
+                          "The number of slots of the calendar",
+                          UintegerValue(200),
+                          MakeUintegerAccessor(&CanlendarQueueDisc::m_nSlots),
+                          MakeUintegerChecker<uint32_t>(2))
+            .AddAttribute("SlotCapacityBytes",
+                          "The maximum number of bytes each slot can be assigned per round. "
+                          "If zero, the number of bytes the link can drain in a "
+                          "RotationInterval is used.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&CanlendarQueueDisc::m_slotCapacityBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("DrainRate",
+                          "The rate at which the slots are drained. If zero, the DataRate "
+                          "attribute of the device the queue disc is installed on is used.",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&CanlendarQueueDisc::m_drainRate),
+                          MakeDataRateChecker())
+            .AddAttribute("SlotOrdering",
+                          "The order in which the packets of a slot are served",
+                          EnumValue(CanlendarQueueDisc::FIFO),
+                          MakeEnumAccessor<SlotOrdering>(&CanlendarQueueDisc::m_slotOrdering),
+                          MakeEnumChecker(CanlendarQueueDisc::FIFO,
+                                          "Fifo",
+                                          CanlendarQueueDisc::EDF,
+                                          "Edf"))
+            .AddAttribute("BudgetAccounting",
+                          "Whether dequeued packets give their bytes back to the budget of "
+                          "their slot (Credit) or not (Enqueued)",
+                          EnumValue(CanlendarQueueDisc::ENQUEUED_BYTES),
+                          MakeEnumAccessor<BudgetAccounting>(
+                              &CanlendarQueueDisc::m_budgetAccounting),
+                          MakeEnumChecker(CanlendarQueueDisc::ENQUEUED_BYTES,
+                                          "Enqueued",
+                                          CanlendarQueueDisc::CREDIT,
+                                          "Credit"))
+            .AddAttribute("AdmissionMode",
+                          "What to do with a decode packet that cannot be served before its "
+                          "deadline: admit it anyway, drop it, or serve it as best effort "
+                          "in the last slot with enough budget",
+                          EnumValue(CanlendarQueueDisc::ADMIT_ALL),
+                          MakeEnumAccessor<AdmissionMode>(&CanlendarQueueDisc::m_admissionMode),
+                          MakeEnumChecker(CanlendarQueueDisc::ADMIT_ALL,
+                                          "None",
+                                          CanlendarQueueDisc::EARLY_DROP,
+                                          "Drop",
+                                          CanlendarQueueDisc::DOWNGRADE,
+                                          "Downgrade"))
+            .AddAttribute("MaxSize",
+                          "The maximum number of bytes the queue disc can hold.",
+                          QueueSizeValue(QueueSize("1000MB")),
+                          MakeQueueSizeAccessor(&CanlendarQueueDisc::SetMaxSize,
+                                                &CanlendarQueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddTraceSource("SlotBytes",
+                            "Number of bytes stored in a slot",
+                            MakeTraceSourceAccessor(&CanlendarQueueDisc::m_slotBytesTrace),
+                            "ns3::CanlendarQueueDisc::SlotBytesTracedCallback")
+            .AddTraceSource("SlotOverflow",
+                            "A packet does not fit in a slot and is moved to the next one",
+                            MakeTraceSourceAccessor(&CanlendarQueueDisc::m_slotOverflowTrace),
+                            "ns3::CanlendarQueueDisc::SlotOverflowTracedCallback")
+            .AddTraceSource("QueueDelay",
+                            "Queueing delay of a dequeued packet carrying a FlowTypeTag",
+                            MakeTraceSourceAccessor(&CanlendarQueueDisc::m_queueDelayTrace),
+                            "ns3::CanlendarQueueDisc::QueueDelayTracedCallback")
+            .AddTraceSource("DeadlineSlack",
+                            "Time left before the deadline of a dequeued packet "
+                            "carrying a DeadlineTag",
+                            MakeTraceSourceAccessor(&CanlendarQueueDisc::m_deadlineSlackTrace),
+                            "ns3::CanlendarQueueDisc::DeadlineSlackTracedCallback");
+    return tid;
+}
+
+CanlendarQueueDisc::CanlendarQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES),
+      m_rotationOffset(0),
+      m_epoch(0),
+      m_timeoutCount(0),
+      m_dequeuedPackets(0),
+      m_prefillpacket(0),
+      m_slotCapacity(0),
+      m_epochCapacity(0),
+      m_epochDequeuedBytes(0),
+      m_idleBytes(0),
+      m_seq(0),
+      m_nSlotOverflows(0),
+      m_nDowngradedPackets(0)
+{
+    NS_LOG_FUNCTION(this);
+    // The tags resolved for every packet are stored inline in the packets
+    [[maybe_unused]] static bool hot = PacketTagList::RegisterHotTag(FlowTypeTag::GetTypeId()) &&
+                                       PacketTagList::RegisterHotTag(DeadlineTag::GetTypeId()) &&
+                                       PacketTagList::RegisterHotTag(DelayTag::GetTypeId()) &&
+                                       PacketTagList::RegisterHotTag(TimestampTag::GetTypeId());
+}
+
+CanlendarQueueDisc::~CanlendarQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CanlendarQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_slots.clear();
+    m_slotBytes.clear();
+    m_nonEmptySlots.clear();
+    m_slotRounds.clear();
+    QueueDisc::DoDispose();
+}
+
+void
 CanlendarQueueDisc::SetBandForPriority(uint8_t prio, uint16_t band)
- {
-     NS_LOG_FUNCTION(this << prio << band);
- 
-     NS_ASSERT_MSG(prio < 16, "Priority must be a value between 0 and 15");
- 
-     m_prio2band[prio] = band;
- }
- 
- uint16_t
+{
+    NS_LOG_FUNCTION(this << prio << band);
+
+    NS_ASSERT_MSG(prio < 16, "Priority must be a value between 0 and 15");
+
+    m_prio2band[prio] = band;
+}
+
+uint16_t
 CanlendarQueueDisc::GetBandForPriority(uint8_t prio) const
- {
-     NS_LOG_FUNCTION(this << prio);
- 
-     NS_ASSERT_MSG(prio < 16, "Priority must be a value between 0 and 15");
- 
-     return m_prio2band[prio];
- }
- /*
- to:
- check the type of the flow, give different band (=processing time?)
- give flows specific tags or ??
- check the queue full or not
- */
- bool
- CanlendarQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
- {
-     NS_LOG_FUNCTION(this << item);
- 
-     uint32_t band;
-     uint32_t bdelay;
- 
-     NS_ASSERT_MSG(band < GetNQueueDiscClasses(), "Selected band out of range");
-     band = m_rotationOffset; //current round
-     uint32_t queueSizeBefore = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets(); // 记录入队前的队列长度
-     uint32_t packetSize = item->GetPacket()->GetSize();
-     uint32_t csize = GetQueueDiscClass(band)->GetQueueDisc()->GetNBytes();
-     NS_LOG_INFO("current size: "<< csize<<" size " << GetMaxSize().GetValue()<<" packetsize: "<<packetSize);
- 
-    FlowTypeTag flowtype;
-    DeadlineTag ddl;
-    bool hastypetag = item->GetPacket()->PeekPacketTag(flowtype);
-    bool hasddltag = item->GetPacket()->PeekPacketTag(ddl);
-    double ddlvalue = ddl.GetDeadline();
-    if (hastypetag && hasddltag)
-    {
-        NS_LOG_INFO("flowtype: "<<flowtype.GetType());
-        NS_LOG_INFO("ddl: "<<ddlvalue);
-        if(flowtype.GetType()==FlowTypeTag::PREFILL)
+{
+    NS_LOG_FUNCTION(this << prio);
+
+    NS_ASSERT_MSG(prio < 16, "Priority must be a value between 0 and 15");
+
+    return m_prio2band[prio];
+}
+
+uint32_t
+CanlendarQueueDisc::GetNSlots() const
+{
+    return m_slots.size();
+}
+
+uint32_t
+CanlendarQueueDisc::GetSlotNPackets(uint32_t slot) const
+{
+    NS_ASSERT(slot < m_slots.size());
+    return m_slots[slot].size();
+}
+
+uint32_t
+CanlendarQueueDisc::GetSlotNBytes(uint32_t slot) const
+{
+    NS_ASSERT(slot < m_slotBytes.size());
+    return m_slotBytes[slot];
+}
+
+uint32_t
+CanlendarQueueDisc::GetCurrentSlot() const
+{
+    return m_slots.empty() ? 0 : GetEpoch() % m_slots.size();
+}
+
+DataRate
+CanlendarQueueDisc::GetDrainRate() const
+{
+    return m_linkRate;
+}
+
+uint64_t
+CanlendarQueueDisc::GetSlotCapacity() const
+{
+    return m_slotCapacity;
+}
+
+const CanlendarQueueDisc::LatencyHistogram&
+CanlendarQueueDisc::GetQueueDelayHistogram(FlowTypeTag::FlowType flowType) const
+{
+    NS_ASSERT(flowType < m_queueDelay.size());
+    return m_queueDelay[flowType];
+}
+
+const CanlendarQueueDisc::LatencyHistogram&
+CanlendarQueueDisc::GetDeadlineSlackHistogram() const
+{
+    return m_deadlineSlack;
+}
+
+const CanlendarQueueDisc::LatencyHistogram&
+CanlendarQueueDisc::GetDeadlineMissHistogram() const
+{
+    return m_deadlineMiss;
+}
+
+uint64_t
+CanlendarQueueDisc::GetNSlotOverflows() const
+{
+    return m_nSlotOverflows;
+}
+
+uint64_t
+CanlendarQueueDisc::GetNDowngradedPackets() const
+{
+    return m_nDowngradedPackets;
+}
+
+uint64_t
+CanlendarQueueDisc::GetNIdleBytes() const
+{
+    return m_idleBytes;
+}
+
+double
+CanlendarQueueDisc::GetUtilization() const
+{
+    if (m_epoch == 0 || m_epochCapacity == 0)
+    {
+        return 0;
+    }
+    double capacity = static_cast<double>(m_epoch) * m_epochCapacity;
+    return 1 - m_idleBytes / capacity;
+}
+
+CanlendarQueueDisc::ItemInfo
+CanlendarQueueDisc::ClassifyItem(Ptr<QueueDiscItem> item) const
+{
+    NS_LOG_FUNCTION(this << item);
+
+    static const TypeId flowTypeTid = FlowTypeTag::GetTypeId();
+    static const TypeId deadlineTid = DeadlineTag::GetTypeId();
+    static const TypeId delayTid = DelayTag::GetTypeId();
+    static const TypeId timestampTid = TimestampTag::GetTypeId();
+
+    ItemInfo info;
+    bool hasTimestamp = false;
+    // like PeekPacketTag, only the first tag of each type is considered
+    PacketTagIterator it = item->GetPacket()->GetPacketTagIterator();
+    while (it.HasNext())
+    {
+        PacketTagIterator::Item tag = it.Next();
+        TypeId tid = tag.GetTypeId();
+        if (tid == flowTypeTid && !info.hasFlowType)
         {
-            for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-            {
-                Time current_enqueue_time = Simulator::Now();
- 
-                band = (i + m_rotationOffset) % GetNQueueDiscClasses();
-                Time remain_time =  Seconds(1) -(current_enqueue_time - rotation_time);
-                remain_bytes[band] = remain_time.ToDouble(Time::S) * (25*10e6)-csize;
-                if(band==m_rotationOffset)
-                {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue()&&packetSize<=remain_bytes[band])
-                    {
-                        bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                        TimestampTag tsTag;
-                        if(!item->GetPacket()->PeekPacketTag(tsTag)){
-                        tsTag.SetTimestamp(Simulator::Now());
-                        item->GetPacket()->AddPacketTag(tsTag);}
-                        NS_LOG_INFO("need time:"<<packetSize*8/(2*10e6));
-
-                        uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                        m_Bytesbudget[band] +=  item->GetSize();
-
-                        NS_LOG_LOGIC("ttt " << ttt);
-                        NS_LOG_LOGIC("Packet enqueued to band " << band
-                            << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                            << " packet size: " << packetSize
-                            <<" time now:"<< rotation_time
-                            <<" bytebudget:" << m_Bytesbudget[band]
-                            <<" flowtype"<<(flowtype.GetType() == FlowTypeTag::PREFILL ? "PREFILL" : "DECODE")
-                            <<" remainbytes:"<<remain_bytes[band]
-                            << "). Success: " << retval);
-                            return retval;
-                    }
-                }
-                else
-                {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue())
-                    {
-                        bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                        TimestampTag tsTag;
-                        if(!item->GetPacket()->PeekPacketTag(tsTag)){
-                        tsTag.SetTimestamp(Simulator::Now());
-                        item->GetPacket()->AddPacketTag(tsTag);}
-                        NS_LOG_INFO("need time:"<<packetSize*8/(2*10e6));
-
-                        uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                        m_Bytesbudget[band] +=  item->GetSize();
-
-                        NS_LOG_LOGIC("ttt " << ttt);
-                        NS_LOG_LOGIC("Packet enqueued to band " << band
-                            << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                            << " packet size: " << packetSize
-                            <<" time now:"<< rotation_time
-                            <<" bytebudget:" << m_Bytesbudget[band]
-                            <<" flowtype"<<(flowtype.GetType() == FlowTypeTag::PREFILL ? "PREFILL" : "DECODE")
-                            <<" remainbytes:"<<remain_bytes[band]
-                            << "). Success: " << retval);
-                            return retval;
-                    }
-                }
-                NS_LOG_WARN("Queue "<<band<<" is full! Moving packet to next queue."<<(band+1)
-                <<" remainbytes:"<<remain_bytes[band]
-                <<". Queue size: "<<(GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets())
-                <<" bytebudget:" << m_Bytesbudget[band]
-                <<" time now:"<< current_enqueue_time);
-            }
- 
+            FlowTypeTag flowType;
+            tag.GetTag(flowType);
+            info.hasFlowType = true;
+            info.flowType = flowType.GetType();
+        }
+        else if (tid == deadlineTid && !info.hasDeadline)
+        {
+            DeadlineTag deadline;
+            tag.GetTag(deadline);
+            info.hasDeadline = true;
+            info.deadline = deadline.GetDeadline();
+        }
+        else if (tid == delayTid && !info.hasDelay)
+        {
+            DelayTag delay;
+            tag.GetTag(delay);
+            info.hasDelay = true;
+            info.delay = delay.GetTimestamp();
+        }
+        else if (tid == timestampTid && !hasTimestamp)
+        {
+            TimestampTag timestamp;
+            tag.GetTag(timestamp);
+            hasTimestamp = true;
+            info.timestamp = timestamp.GetTimestamp();
+        }
+    }
+
+    if (!hasTimestamp)
+    {
+        info.timestamp = Simulator::Now();
+        item->GetPacket()->AddPacketTag(TimestampTag(info.timestamp));
+    }
+    if (info.hasDeadline)
+    {
+        info.expiry = Simulator::Now() + Seconds(info.deadline) - info.delay;
+    }
+    return info;
+}
+
+bool
+CanlendarQueueDisc::ServedAfter(const SlotEntry& a, const SlotEntry& b)
+{
+    // packets downgraded to best effort are served as those with no deadline
+    Time aKey = a.info.bestEffort ? Time::Max() : a.info.expiry;
+    Time bKey = b.info.bestEffort ? Time::Max() : b.info.expiry;
+    return aKey > bKey || (aKey == bKey && a.seq > b.seq);
+}
+
+void
+CanlendarQueueDisc::EnqueueIntoSlot(uint32_t slot, Ptr<QueueDiscItem> item, const ItemInfo& info)
+{
+    NS_LOG_FUNCTION(this << slot << item);
+
+    m_slots[slot].push_back({item, info, m_seq++, m_slotRounds[slot]});
+    if (m_slotOrdering == EDF)
+    {
+        std::push_heap(m_slots[slot].begin(), m_slots[slot].end(), &ServedAfter);
+    }
+    m_slotBytes[slot] += item->GetSize();
+    m_nonEmptySlots[slot / 64] |= (uint64_t{1} << (slot % 64));
+    m_Bytesbudget[slot] += item->GetSize();
+    m_slotBytesTrace(slot, m_slotBytes[slot]);
+
+    PacketEnqueued(item);
+}
+
+uint32_t
+CanlendarQueueDisc::FindNonEmptySlot(uint32_t from) const
+{
+    std::size_t nWords = m_nonEmptySlots.size();
+    std::size_t word = from / 64;
+    uint64_t bits = m_nonEmptySlots[word] & (~uint64_t{0} << (from % 64));
+
+    // scan one word more than the bitmap size to wrap around to the bits of
+    // the starting word that precede the starting slot
+    for (std::size_t i = 0; i <= nWords; i++)
+    {
+        if (bits)
+        {
+            return word * 64 + std::countr_zero(bits);
+        }
+        word = (word + 1) % nWords;
+        bits = m_nonEmptySlots[word];
+    }
+    return m_slots.size();
+}
+
+bool
+CanlendarQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    UpdateRotation();
+
+    uint32_t nSlots = m_slots.size();
+    uint32_t packetSize = item->GetPacket()->GetSize();
+    uint32_t csize = m_slotBytes[m_rotationOffset];
+    NS_LOG_INFO("current size: " << csize << " size " << m_slotCapacity
+                                 << " packetsize: " << packetSize);
+
+    if (GetCurrentSize() + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        DropBeforeEnqueue(item, LIMIT_EXCEEDED_DROP);
+        return false;
+    }
+
+    ItemInfo info = ClassifyItem(item);
+
+    // slot where the search for a slot with enough budget starts
+    uint32_t first = m_rotationOffset;
+    if (info.hasFlowType && info.hasDeadline)
+    {
+        NS_LOG_INFO("flowtype: " << info.flowType);
+        NS_LOG_INFO("ddl: " << info.deadline);
+        if (info.flowType == FlowTypeTag::DECODE)
+        {
+            double accumulated = info.hasDelay ? NanoTicks(info.delay).GetSeconds() : 0;
+            double interval = NanoTicks(m_rotationInterval).GetSeconds();
+            uint16_t backward = static_cast<int>(floor((info.deadline - accumulated) / interval));
+            NS_LOG_INFO((info.deadline - accumulated) / interval << " back" << backward);
+            first = m_rotationOffset + backward - 1;
+        }
+    }
+    else
+    {
+        NS_LOG_INFO("NO TAGS");
+    }
+
+    // bytes the current slot can still send before the next rotation
+    NanoTicks remainTime =
+        NanoTicks(m_rotationInterval) - (NanoTicks(Simulator::Now()) - NanoTicks(rotation_time));
+    double remainBytes = remainTime.GetSeconds() * m_linkRate.GetBitRate() / 8 - csize;
+
+    uint32_t band = nSlots;
+    for (uint32_t i = 0; i < nSlots; i++)
+    {
+        uint32_t slot = (i + first) % nSlots;
+        if (CanAdmit(slot, item, remainBytes))
+        {
+            band = slot;
+            break;
+        }
+        NS_LOG_WARN("Queue " << slot << " is full! Moving packet to next queue." << (slot + 1)
+                             << " remainbytes:" << remainBytes
+                             << ". Queue size: " << m_slots[slot].size()
+                             << " bytebudget:" << m_Bytesbudget[slot]
+                             << " time now:" << Simulator::Now());
+        m_nSlotOverflows++;
+        m_slotOverflowTrace(item, slot);
+    }
+
+    // admission control: a decode packet that would be served after its
+    // deadline is moved to a slot that is served in time, if any
+    if (m_admissionMode != ADMIT_ALL && info.hasFlowType &&
+        info.flowType == FlowTypeTag::DECODE && info.hasDeadline &&
+        (band == nSlots || GetFinishTime(band, item) > info.expiry))
+    {
+        uint32_t feasible = FindFeasibleSlot(item, info, remainBytes);
+        if (feasible < nSlots)
+        {
+            band = feasible;
+        }
+        else if (m_admissionMode == EARLY_DROP)
+        {
+            NS_LOG_LOGIC("The deadline cannot be met -- dropping pkt");
+            DropBeforeEnqueue(item, DEADLINE_UNREACHABLE_DROP);
+            return false;
         }
-        else if(flowtype.GetType()==FlowTypeTag::DECODE)
+        else if (band < nSlots)
         {
-           DelayTag delaytag;
-            for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+            NS_LOG_LOGIC("The deadline cannot be met -- serving pkt as best effort");
+            // move the packet to the slot served last that has enough budget;
+            // the slot found above has enough budget, hence is the fallback
+            uint32_t bandPos = (band + nSlots - m_rotationOffset) % nSlots;
+            for (uint32_t i = nSlots - 1; i > bandPos; i--)
             {
-                Time current_enqueue_time = Simulator::Now();
-                uint16_t backward = static_cast<int>(floor((ddl.GetDeadline()- (item->GetPacket()->PeekPacketTag(delaytag)?delaytag.GetTimestamp().GetSeconds():0))/m_rotationInterval.GetSeconds()));
-                NS_LOG_INFO((ddl.GetDeadline()- (item->GetPacket()->PeekPacketTag(delaytag)?delaytag.GetTimestamp().GetSeconds():0))/m_rotationInterval.GetSeconds()<<" back"<<backward);
-                band = (i + m_rotationOffset+ backward - 1) % GetNQueueDiscClasses();
-                Time remain_time =  Seconds(1) -(current_enqueue_time - rotation_time);
-                remain_bytes[band] = remain_time.ToDouble(Time::S) * (2*10e6)-csize;
-                if(band==m_rotationOffset)
+                uint32_t slot = (i + m_rotationOffset) % nSlots;
+                if (CanAdmit(slot, item, remainBytes))
                 {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue()&&packetSize<=remain_bytes[band])
-                    {
-                    NS_LOG_LOGIC("move to band"<<band);
-                    bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                    TimestampTag tsTag;
-                    if(!item->GetPacket()->PeekPacketTag(tsTag)){
-                    tsTag.SetTimestamp(Simulator::Now());
-                    item->GetPacket()->AddPacketTag(tsTag);}
-                    
-                    uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                    m_Bytesbudget[band] +=  item->GetSize();
-
-                    NS_LOG_INFO("rotation times " << ttt);
-                    NS_LOG_INFO("Packet enqueued to band " << band
-                        << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                        << " packet size: " << packetSize
-                        <<" time now:"<< rotation_time
-                        <<" bytebudget:" << m_Bytesbudget[band]
-                        <<" type: decode"
-                        <<" ddl: "<<ddl.GetDeadline()<<"s"
-                        <<" remainbytes:"<<remain_bytes[band]
-                        << "). Success: " << retval);
-                        return retval;
-                    }
+                    band = slot;
+                    break;
                 }
-                else
-                {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue())
-                    {
-                    NS_LOG_LOGIC("move to band"<<band);
-                    bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                    TimestampTag tsTag;
-                    if(!item->GetPacket()->PeekPacketTag(tsTag)){
-                    tsTag.SetTimestamp(Simulator::Now());
-                    item->GetPacket()->AddPacketTag(tsTag);}
-                    uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                    m_Bytesbudget[band] +=  item->GetSize();
-
-                    NS_LOG_INFO("rotation times " << ttt);
-                    NS_LOG_INFO("Packet enqueued to band " << band
-                        << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                        << " packet size: " << packetSize
-                        <<" time now:"<< rotation_time
-                        <<" bytebudget:" << m_Bytesbudget[band]
-                        <<" type: decode"
-                        <<" ddl: "<<ddl.GetDeadline()<<"s"
-                        <<" remainbytes:"<<remain_bytes[band]
-                        << "). Success: " << retval);
-                        return retval;
-                    }
-                }
-                NS_LOG_WARN("Queue "<<band<<" is full! Moving packet to next queue."<<(band+1)
-                <<" remainbytes:"<<remain_bytes[band]
-                <<". Queue size: "<<(GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets())
-                <<" bytebudget:" << m_Bytesbudget[band]
-                <<" time now:"<< current_enqueue_time);
             }
+            info.bestEffort = true;
+            m_nDowngradedPackets++;
+        }
+    }
+
+    if (band == nSlots)
+    {
+        NS_LOG_LOGIC("No slot has enough budget -- dropping pkt");
+        DropBeforeEnqueue(item, ALL_SLOTS_FULL_DROP);
+        return false;
+    }
+
+    uint32_t queueSizeBefore = m_slots[band].size();
+    EnqueueIntoSlot(band, item, info);
+
+    NS_LOG_LOGIC("Packet enqueued to band "
+                 << band << ". Queue size: " << queueSizeBefore << " -> " << m_slots[band].size()
+                 << " packet size: " << packetSize << " time now:" << rotation_time
+                 << " bytebudget:" << m_Bytesbudget[band] << " remainbytes:" << remainBytes
+                 << " rotation times " << m_epoch);
+    return true;
+}
+
+bool
+CanlendarQueueDisc::CanAdmit(uint32_t slot, Ptr<QueueDiscItem> item, double remainBytes) const
+{
+    return m_Bytesbudget[slot] + item->GetSize() <= m_slotCapacity &&
+           (slot != m_rotationOffset || item->GetPacket()->GetSize() <= remainBytes);
+}
+
+Time
+CanlendarQueueDisc::GetFinishTime(uint32_t slot, Ptr<QueueDiscItem> item) const
+{
+    uint32_t distance = (slot + m_slots.size() - m_rotationOffset) % m_slots.size();
+    // the current slot is already being served, the others start being
+    // served when the calendar rotates to them
+    Time start = distance == 0 ? Simulator::Now() : rotation_time + m_rotationInterval * distance;
+    return start + m_linkRate.CalculateBytesTxTime(m_slotBytes[slot] + item->GetSize());
+}
+
+uint32_t
+CanlendarQueueDisc::FindFeasibleSlot(Ptr<QueueDiscItem> item,
+                                     const ItemInfo& info,
+                                     double remainBytes) const
+{
+    NS_LOG_FUNCTION(this << item);
+
+    // prefer the latest slot that meets the deadline, to leave the earlier
+    // slots to packets with tighter deadlines
+    for (uint32_t distance = m_slots.size(); distance-- > 0;)
+    {
+        if (rotation_time + m_rotationInterval * distance > info.expiry)
+        {
+            continue;
+        }
+        uint32_t slot = (m_rotationOffset + distance) % m_slots.size();
+        if (CanAdmit(slot, item, remainBytes) && GetFinishTime(slot, item) <= info.expiry)
+        {
+            return slot;
         }
     }
+    return m_slots.size();
+}
+
+Ptr<QueueDiscItem>
+CanlendarQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    UpdateRotation();
+
+    uint32_t band = FindNonEmptySlot(m_rotationOffset);
+    if (band == m_slots.size())
+    {
+        NS_LOG_LOGIC("Queue empty!!!! band:" << m_rotationOffset);
+        return nullptr;
+    }
+
+    // in EDF order the head of the slot is the root of the heap
+    Ptr<QueueDiscItem> item = m_slots[band].front().item;
+    ItemInfo info = m_slots[band].front().info;
+    uint64_t round = m_slots[band].front().round;
+    if (m_slotOrdering == EDF)
+    {
+        std::pop_heap(m_slots[band].begin(), m_slots[band].end(), &ServedAfter);
+        m_slots[band].pop_back();
+    }
     else
     {
-    NS_LOG_INFO("NO TAGS");
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+        m_slots[band].pop_front();
+    }
+    m_slotBytes[band] -= item->GetSize();
+    if (m_slots[band].empty())
+    {
+        m_nonEmptySlots[band / 64] &= ~(uint64_t{1} << (band % 64));
+    }
+    m_slotBytesTrace(band, m_slotBytes[band]);
+    PacketDequeued(item);
+
+    // give the bytes back to the budget of the slot, unless the budget has
+    // been reset since the packet was admitted
+    if (m_budgetAccounting == CREDIT && round == m_slotRounds[band])
+    {
+        m_Bytesbudget[band] -= std::min<uint64_t>(m_Bytesbudget[band], item->GetSize());
+    }
+    m_epochDequeuedBytes += item->GetSize();
+
+    // no delaytag->first dequeue->add delaytag=0
+    if (!info.hasDelay)
+    {
+        DelayTag delaytag;
+        delaytag.SetTimestamp(Seconds(0));
+        item->GetPacket()->AddPacketTag(delaytag);
+    }
+
+    if (info.hasDeadline)
+    {
+        Time slack = info.expiry - Simulator::Now();
+        if (slack.IsNegative())
+        {
+            m_deadlineMiss.Record(Simulator::Now() - info.expiry);
+        }
+        else
+        {
+            m_deadlineSlack.Record(slack);
+        }
+        m_deadlineSlackTrace(item, slack);
+    }
+
+    if (info.hasFlowType)
+    {
+        Time delay = Simulator::Now() - info.timestamp;
+        if (info.flowType < m_queueDelay.size())
+        {
+            m_queueDelay[info.flowType].Record(delay);
+        }
+        m_queueDelayTrace(item, info.flowType, delay);
+        if (info.flowType == FlowTypeTag::DECODE)
+        {
+            m_totalQueueDelay += delay;
+            m_dequeuedPackets++;
+            NS_LOG_INFO("Decode packet delay: " << delay.GetSeconds() << " s");
+            if (delay > m_timeoutThreshold)
             {
-                Time current_enqueue_time = Simulator::Now();
- 
-                band = (i + m_rotationOffset) % GetNQueueDiscClasses();
-                Time remain_time =  Seconds(1) -(current_enqueue_time - rotation_time);
-                remain_bytes[band] = remain_time.ToDouble(Time::S) * (2*10e6)-csize;
-                if(band==m_rotationOffset)
-                {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue()&&packetSize<=remain_bytes[band])
-                    {
-                        bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                        NS_LOG_INFO("need time:"<<packetSize*8/(2*10e6));
-
-                        uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                        m_Bytesbudget[band] +=  item->GetSize();
-
-                        NS_LOG_LOGIC("ttt " << ttt);
-                        NS_LOG_LOGIC("Packet enqueued to band " << band
-                            << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                            << " packet size: " << packetSize
-                            <<" time now:"<< rotation_time
-                            <<" bytebudget:" << m_Bytesbudget[band]
-                            <<" flowtype"<<(flowtype.GetType() == FlowTypeTag::PREFILL ? "PREFILL" : "DECODE")
-                            <<" remainbytes:"<<remain_bytes[band]
-                            << "). Success: " << retval);
-                            return retval;
-                    }
-                }
-                else
-                {
-                    if (m_Bytesbudget[band] + item->GetSize() <= GetMaxSize().GetValue())
-                    {
-                        bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
-                        NS_LOG_INFO("need time:"<<packetSize*8/(2*10e6));
-
-                        uint32_t queueSizeAfter = GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets();
-                        m_Bytesbudget[band] +=  item->GetSize();
-
-                        NS_LOG_LOGIC("ttt " << ttt);
-                        NS_LOG_LOGIC("Packet enqueued to band " << band
-                            << ". Queue size: " << queueSizeBefore << " -> " << queueSizeAfter
-                            << " packet size: " << packetSize
-                            <<" time now:"<< rotation_time
-                            <<" bytebudget:" << m_Bytesbudget[band]
-                            <<" flowtype"<<(flowtype.GetType() == FlowTypeTag::PREFILL ? "PREFILL" : "DECODE")
-                            <<" remainbytes:"<<remain_bytes[band]
-                            << "). Success: " << retval);
-                            return retval;
-                    }
-                }
-                NS_LOG_WARN("Queue "<<band<<" is full! Moving packet to next queue."<<(band+1)
-                <<" remainbytes:"<<remain_bytes[band]
-                <<". Queue size: "<<(GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets())
-                <<" bytebudget:" << m_Bytesbudget[band]
-                <<" time now:"<< current_enqueue_time);
+                m_timeoutCount++;
+                NS_LOG_INFO("Packet timeout: delay = " << delay.GetSeconds() << " s");
             }
+        }
+        else if (info.flowType == FlowTypeTag::PREFILL)
+        {
+            m_pt += delay;
+            m_prefillpacket++;
+        }
     }
- 
- }
- 
- Ptr<QueueDiscItem>
- CanlendarQueueDisc::DoDequeue()
- {
-     NS_LOG_FUNCTION(this);
-     
-     Time m_delay=Seconds(0);
-     Ptr<QueueDiscItem> item;
-     uint32_t band = m_rotationOffset;
-     for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-     {
-         
-         band = (i + m_rotationOffset) % GetNQueueDiscClasses();
-         if ((item = GetQueueDiscClass(band)->GetQueueDisc()->Dequeue()))
-         {   
-             DelayTag delaytag;
-              //no delaytag->first dequeue->add delaytag=0
-             if(!item->GetPacket()->PeekPacketTag(delaytag)){
-                 delaytag.SetTimestamp(Seconds(0));
-                 item->GetPacket()->AddPacketTag(delaytag);
-             }
-             
-             uint32_t csize = GetQueueDiscClass(band)->GetQueueDisc()->GetNBytes();
-             uint32_t packetSize = item->GetPacket()->GetSize();
-             FlowTypeTag flowType;
-             if (item->GetPacket()->PeekPacketTag(flowType) && flowType.GetType() == FlowTypeTag::DECODE)
-             {
-                TimestampTag tsTag;
-                DelayTag dtag;
-                if (item->GetPacket()->PeekPacketTag(tsTag)&&item->GetPacket()->PeekPacketTag(dtag))
-                {
-                    Time delay = Simulator::Now() - tsTag.GetTimestamp();
-                    m_totalQueueDelay += delay;
-                    m_dequeuedPackets++;
-                    m_delay = dtag.GetTimestamp() + delay - m_timeoutThreshold;
-                    dtag.SetTimestamp(m_delay>=Seconds(0)?m_delay:Seconds(0));
-                    NS_LOG_INFO("Decode packet delay: " << delay.GetSeconds() << " s");
-                    if (delay > m_timeoutThreshold)
-                    {
-                        m_timeoutCount++;
-                    NS_LOG_INFO("Packet timeout: delay = " << delay.GetSeconds() << " s");
-                    }
-                }
-                
-            }
-            if(item->GetPacket()->PeekPacketTag(flowType)&&flowType.GetType()==FlowTypeTag::PREFILL)
+
+    NS_LOG_INFO("Popped from band " << band << ": " << item);
+    NS_LOG_INFO("Number packets band " << band << ": " << m_slots[band].size()
+                                       << " current size: " << m_slotBytes[band]
+                                       << " packetsize: " << item->GetPacket()->GetSize()
+                                       << " time:" << Simulator::Now());
+    return item;
+}
+
+Ptr<const QueueDiscItem>
+CanlendarQueueDisc::DoPeek()
+{
+    NS_LOG_FUNCTION(this);
+
+    UpdateRotation();
+
+    uint32_t band = FindNonEmptySlot(m_rotationOffset);
+    if (band == m_slots.size())
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    NS_LOG_LOGIC("Peeked from band " << band << ": " << m_slots[band].front().item);
+    return m_slots[band].front().item;
+}
+
+bool
+CanlendarQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("CanlendarQueueDisc cannot have internal queues");
+        return false;
+    }
+
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("CanlendarQueueDisc cannot have classes");
+        return false;
+    }
+
+    if (!m_rotationInterval.IsStrictlyPositive())
+    {
+        NS_LOG_ERROR("The rotation interval of CanlendarQueueDisc must be positive");
+        return false;
+    }
+
+    if (GetMaxSize().GetUnit() != QueueSizeUnit::BYTES)
+    {
+        NS_LOG_ERROR("The size of CanlendarQueueDisc must be expressed in bytes");
+        return false;
+    }
+
+    m_linkRate = m_drainRate;
+    if (m_linkRate.GetBitRate() == 0 && GetNetDeviceQueueInterface())
+    {
+        Ptr<NetDevice> device = GetNetDeviceQueueInterface()->GetObject<NetDevice>();
+        DataRateValue rate;
+        if (device && device->GetAttributeFailSafe("DataRate", rate))
+        {
+            m_linkRate = rate.Get();
+
+            // a queue disc that is not the root queue disc of a multi-queue
+            // device is the child of a multi-queue queue disc (such as
+            // MqQueueDisc) and only serves one of the transmission queues,
+            // which share the device rate evenly
+            std::size_t nTxQueues = GetNetDeviceQueueInterface()->GetNTxQueues();
+            Ptr<Node> node = device->GetNode();
+            Ptr<TrafficControlLayer> tc = node ? node->GetObject<TrafficControlLayer>() : nullptr;
+            if (nTxQueues > 1 && tc && tc->GetRootQueueDiscOnDevice(device) != this)
             {
-                TimestampTag tsTag;
-                if (item->GetPacket()->PeekPacketTag(tsTag))
-                {
-                Time delay = Simulator::Now() - tsTag.GetTimestamp();
-                m_pt += delay;
-                m_prefillpacket++;
-                }
+                m_linkRate = DataRate(m_linkRate.GetBitRate() / nTxQueues);
             }
-             NS_LOG_INFO("Popped from band " << band << ": " << item);
-             NS_LOG_INFO("Number packets band "
-                          << band << ": " << GetQueueDiscClass(i)->GetQueueDisc()->GetNPackets()
-                          <<" current size: "<< csize
-                          <<" packetsize: "<< packetSize
-                          <<" time:"<<Simulator::Now());
-             return item;
-         }
-   
-     }
-     NS_LOG_LOGIC("Queue empty!!!! band:"<<band);
-     return item;
-    //  if ((item = GetQueueDiscClass(band)->GetQueueDisc()->Dequeue()))
-    //      {   
-    //          uint32_t csize = GetQueueDiscClass(band)->GetQueueDisc()->GetNBytes();
-    //          NS_LOG_LOGIC("Popped from band " << band << ": " << item);
-    //          NS_LOG_LOGIC("Number packets band "
-    //                       << band << ": " << GetQueueDiscClass(band)->GetQueueDisc()->GetNPackets()
-    //                       <<" bytebudget: "<< m_Bytesbudget[band]
-    //          );
-    //          return item;
-    //      }
-    //  NS_LOG_LOGIC("Queue empty!!!!"<<m_rotationOffset);
-    //  return item;
- }
- 
- Ptr<const QueueDiscItem>
- CanlendarQueueDisc::DoPeek()
- {
-     NS_LOG_FUNCTION(this);
- 
-     Ptr<const QueueDiscItem> item;
- 
-     for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-     {
-         if ((item = GetQueueDiscClass(i)->GetQueueDisc()->Peek()))
-         {
-             NS_LOG_LOGIC("Peeked from band " << i << ": " << item);
-             NS_LOG_LOGIC("Number packets band "
-                          << i << ": " << GetQueueDiscClass(i)->GetQueueDisc()->GetNPackets());
-             return item;
-         }
-     }
- 
-     NS_LOG_LOGIC("Queue empty");
-     return item;
- }
- 
- bool
- CanlendarQueueDisc::CheckConfig()
- {
-     NS_LOG_FUNCTION(this);
-     if (GetNInternalQueues() > 0)
-     {
-         NS_LOG_ERROR("CanlendarQueueDisc cannot have internal queues");
-         return false;
-     }
- 
-     if (GetNQueueDiscClasses() == 0)
-     {
-         // create 3 fifo queue discs
-         ObjectFactory factory;
-         factory.SetTypeId("ns3::FifoQueueDisc");
-         for (uint8_t i = 0; i <200; i++)
-         {
-             Ptr<QueueDisc> qd = factory.Create<QueueDisc>();
-             qd->Initialize();
-             Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass>();
-             c->SetQueueDisc(qd);
-             AddQueueDiscClass(c);
-         }
-     }
- 
-     if (GetNQueueDiscClasses() < 2)
-     {
-         NS_LOG_ERROR("CanlendarQueueDisc needs at least 2 classes");
-         return false;
-     }
- 
-     return true;
- }
- //111
- void
- CanlendarQueueDisc::RotatePriority()
-{
-     NS_LOG_FUNCTION(this);
-    // 轮转偏移量加1，模队列数量
-    uint32_t lbytes = GetQueueDiscClass(m_rotationOffset)->GetQueueDisc()->GetNBytes();
-    NS_LOG_INFO("queue:"<<m_rotationOffset<<" current queue bytes:"<<lbytes);
-    m_Bytesbudget[m_rotationOffset] = 0;
-
-    NS_LOG_INFO("Cleared byte count for band " << m_rotationOffset);
-    ttt = ttt + 1;
-    rotation_time = Simulator::Now();
-     m_rotationOffset = (m_rotationOffset + 1) % GetNQueueDiscClasses();
-     remain_bytes.resize(GetNQueueDiscClasses(), qsize);
-    // 重新安排下一次轮转
-     m_rotationEvent = Simulator::Schedule(m_rotationInterval, &CanlendarQueueDisc::RotatePriority, this);
-     NS_LOG_INFO("current band: "<< m_rotationOffset<<" rotation times: "<<ttt<<" time now:"<<rotation_time);
-    }    
- void
- CanlendarQueueDisc::InitializeParams()
- {
-     NS_LOG_FUNCTION(this);
-     uint16_t ttt = 0;
-     m_rotationOffset = 0;
-     m_timeoutCount = 0;
-     m_timeoutThreshold = Seconds(0.01);
-     m_dequeuedPackets = 0;
-     m_Bytesbudget.resize(GetNQueueDiscClasses(), 0);
-     remain_bytes.resize(GetNQueueDiscClasses(), qsize);
-    // 每隔10秒轮转一次
-     m_rotationEvent = Simulator::Schedule(m_rotationInterval, &CanlendarQueueDisc::RotatePriority, this);
-  }
-  void
-CanlendarQueueDisc::ReportTimeoutStatistics () const
-{
-    double avgDelay = (m_dequeuedPackets > 0) ? m_totalQueueDelay.GetSeconds() / m_dequeuedPackets : 0.0;
-    double timeoutRate = (m_dequeuedPackets > 0) ? static_cast<double>(m_timeoutCount) / m_dequeuedPackets : 0.0;
-    double avgp = (m_prefillpacket>0) ? m_pt.GetSeconds() / m_prefillpacket : 0.0;
+        }
+    }
+
+    if (m_linkRate.GetBitRate() == 0)
+    {
+        NS_LOG_ERROR("The drain rate of CanlendarQueueDisc cannot be derived from the device; "
+                     "set the DrainRate attribute");
+        return false;
+    }
+
+    m_epochCapacity = m_linkRate.GetBitRate() / 8 * m_rotationInterval.GetSeconds();
+    m_slotCapacity = m_slotCapacityBytes;
+    if (m_slotCapacity == 0)
+    {
+        m_slotCapacity = m_epochCapacity;
+    }
+
+    return true;
+}
+
+uint64_t
+CanlendarQueueDisc::GetEpoch() const
+{
+    return (Simulator::Now() - m_startTime).GetTimeStep() / m_rotationInterval.GetTimeStep();
+}
+
+void
+CanlendarQueueDisc::UpdateRotation()
+{
+    uint64_t epoch = GetEpoch();
+    if (epoch == m_epoch)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+
+    // reset the budget of the slots left behind, i.e., those that were the
+    // current slot in epochs m_epoch to epoch - 1 (at most once per slot)
+    uint64_t nLeft = std::min<uint64_t>(epoch - m_epoch, m_slots.size());
+    for (uint64_t i = 1; i <= nLeft; i++)
+    {
+        uint32_t slot = (epoch - i) % m_slots.size();
+        m_Bytesbudget[slot] = 0;
+        m_slotRounds[slot]++;
+        NS_LOG_INFO("Cleared byte count for band " << slot);
+    }
+
+    // the link capacity of the rotation intervals elapsed since the previous
+    // update that has not been used by dequeued packets is lost
+    m_idleBytes += m_epochCapacity - std::min(m_epochCapacity, m_epochDequeuedBytes);
+    m_idleBytes += (epoch - m_epoch - 1) * m_epochCapacity;
+    m_epochDequeuedBytes = 0;
+
+    m_epoch = epoch;
+    rotation_time = TimeStep(m_startTime.GetTimeStep() + epoch * m_rotationInterval.GetTimeStep());
+    m_rotationOffset = epoch % m_slots.size();
+    NS_LOG_INFO("current band: " << m_rotationOffset << " rotation times: " << m_epoch
+                                 << " time now:" << rotation_time);
+}
+
+void
+CanlendarQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+    m_startTime = Simulator::Now();
+    m_epoch = 0;
+    rotation_time = m_startTime;
+    m_rotationOffset = 0;
+    m_timeoutCount = 0;
+    m_timeoutThreshold = Seconds(0.01);
+    m_dequeuedPackets = 0;
+    m_prefillpacket = 0;
+    m_slots.assign(m_nSlots, {});
+    m_slotBytes.assign(m_nSlots, 0);
+    m_nonEmptySlots.assign((m_nSlots + 63) / 64, 0);
+    m_Bytesbudget.assign(m_nSlots, 0);
+    m_slotRounds.assign(m_nSlots, 0);
+    m_epochDequeuedBytes = 0;
+    m_idleBytes = 0;
+    for (auto& histogram : m_queueDelay)
+    {
+        histogram.Reset();
+    }
+    m_deadlineSlack.Reset();
+    m_deadlineMiss.Reset();
+    m_nSlotOverflows = 0;
+    m_nDowngradedPackets = 0;
+    NS_LOG_DEBUG("Slots: " << m_nSlots << " drain rate: " << m_linkRate
+                           << " slot capacity: " << m_slotCapacity << " bytes");
+}
+
+void
+CanlendarQueueDisc::ReportTimeoutStatistics() const
+{
+    double avgDelay =
+        (m_dequeuedPackets > 0) ? m_totalQueueDelay.GetSeconds() / m_dequeuedPackets : 0.0;
+    double timeoutRate =
+        (m_dequeuedPackets > 0) ? static_cast<double>(m_timeoutCount) / m_dequeuedPackets : 0.0;
+    double avgp = (m_prefillpacket > 0) ? m_pt.GetSeconds() / m_prefillpacket : 0.0;
     std::cout << "===== Calendar Queue Timeout Statistics =====" << std::endl;
     std::cout << "Total dequeued decode packets: " << m_dequeuedPackets << std::endl;
-    std::cout << "Total delay: " << m_totalQueueDelay.GetSeconds()<<"S" << std::endl;
+    std::cout << "Total delay: " << m_totalQueueDelay.GetSeconds() << "S" << std::endl;
     std::cout << "Total timeout packets: " << m_timeoutCount << std::endl;
     std::cout << "Average queue delay: " << avgDelay << " s" << std::endl;
     std::cout << "Average pt: " << avgp << " s" << std::endl;
     std::cout << "Timeout rate: " << timeoutRate * 100 << " %" << std::endl;
+    const LatencyHistogram& decode = m_queueDelay[FlowTypeTag::DECODE];
+    const LatencyHistogram& prefill = m_queueDelay[FlowTypeTag::PREFILL];
+    std::cout << "Decode queue delay p50/p99/p999: " << decode.GetPercentile(0.5).GetSeconds()
+              << "/" << decode.GetPercentile(0.99).GetSeconds() << "/"
+              << decode.GetPercentile(0.999).GetSeconds() << " s" << std::endl;
+    std::cout << "Prefill queue delay p50/p99/p999: " << prefill.GetPercentile(0.5).GetSeconds()
+              << "/" << prefill.GetPercentile(0.99).GetSeconds() << "/"
+              << prefill.GetPercentile(0.999).GetSeconds() << " s" << std::endl;
+    std::cout << "Deadline misses: " << m_deadlineMiss.GetCount() << " (p99 lateness "
+              << m_deadlineMiss.GetPercentile(0.99).GetSeconds() << " s)" << std::endl;
+    std::cout << "Slot overflows: " << m_nSlotOverflows << std::endl;
+    std::cout << "Downgraded packets: " << m_nDowngradedPackets << std::endl;
+    std::cout << "Link utilization: " << GetUtilization() * 100 << " % (" << m_idleBytes
+              << " idle bytes)" << std::endl;
     std::cout << "=========================================" << std::endl;
-  }
-  void 
-  CanlendarQueueDisc::SetQSize(uint32_t size) 
-  {
-    qsize = size;
-  }
- } // namespace ns3
- 
\ No newline at end of file
+}
+
+CanlendarQueueDisc::LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+uint32_t
+CanlendarQueueDisc::LatencyHistogram::GetBucket(uint64_t ns)
+{
+    constexpr uint32_t subBits = std::countr_zero(SUB_BUCKETS);
+    if (ns < SUB_BUCKETS)
+    {
+        return ns;
+    }
+    // the bucket index is made of the position of the most significant bit
+    // followed by the subBits bits that come after it
+    uint32_t shift = std::bit_width(ns) - 1 - subBits;
+    return (shift + 1) * SUB_BUCKETS + ((ns >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t
+CanlendarQueueDisc::LatencyHistogram::GetUpperBound(uint32_t bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    uint32_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t mantissa = SUB_BUCKETS + bucket % SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void
+CanlendarQueueDisc::LatencyHistogram::Record(Time value)
+{
+    uint64_t ns = value.IsStrictlyPositive() ? value.GetNanoSeconds() : 0;
+    m_buckets[GetBucket(ns)]++;
+    m_count++;
+    m_max = std::max(m_max, ns);
+}
+
+uint64_t
+CanlendarQueueDisc::LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+Time
+CanlendarQueueDisc::LatencyHistogram::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+Time
+CanlendarQueueDisc::LatencyHistogram::GetPercentile(double q) const
+{
+    NS_ASSERT_MSG(q >= 0 && q <= 1, "The percentile must be a value between 0 and 1");
+    if (m_count == 0)
+    {
+        return Time(0);
+    }
+    auto rank = std::max<uint64_t>(1, std::ceil(q * m_count));
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < N_BUCKETS; bucket++)
+    {
+        seen += m_buckets[bucket];
+        if (seen >= rank)
+        {
+            // the bucket of the largest sample may extend beyond it
+            return NanoSeconds(std::min(GetUpperBound(bucket), m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+void
+CanlendarQueueDisc::LatencyHistogram::Reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+} // namespace ns3
@@ -1,117 +1,515 @@
 #ifndef CALENDAR_QUEUE_DISC_H
 #define CALENDAR_QUEUE_DISC_H
 
-#include "ns3/queue-disc.h"
-#include "ns3/event-id.h"
- #include "ns3/core-module.h"
- #include <array>
- 
- namespace ns3
- {
- 
- /// Priority map
- typedef std::array<uint16_t, 16> Priomap;
- 
- /**
-  * \ingroup traffic-control
-  *
-  * The Prio qdisc is a simple classful queueing discipline that contains an
-  * arbitrary number of classes of differing priority. The classes are dequeued
-  * in numerical descending order of priority. By default, three Fifo queue
-  * discs are created, unless the user provides (at least two) child queue
-  * discs.
-  *
-  * If no packet filter is installed or able to classify a packet, then the
-  * packet is assigned a priority band based on its priority (modulo 16), which
-  * is used as an index into an array called priomap. If a packet is classified
-  * by a packet filter and the returned value is non-negative and less than the
-  * number of priority bands, then the packet is assigned the priority band
-  * corresponding to the value returned by the packet filter. Otherwise, the
-  * packet is assigned the priority band specified by the first element of the
-  * priomap array.
-  */
- class CanlendarQueueDisc : public QueueDisc
- {
-   public:
-     /**
-      * \brief Get the type ID.
-      * \return the object TypeId
-      */
-     static TypeId GetTypeId();
-     /**
-      * \brief CanlendarQueueDisc constructor
-      */
-     CanlendarQueueDisc();
- 
-     ~CanlendarQueueDisc() override;
- 
-     /**
-      * Set the band (class) assigned to packets with specified priority.
-      *
-      * \param prio the priority of packets (a value between 0 and 15).
-      * \param band the band assigned to packets.
-      */
-     void SetBandForPriority(uint8_t prio, uint16_t band);
- 
-     /**
-      * Get the band (class) assigned to packets with specified priority.
-      *
-      * \param prio the priority of packets (a value between 0 and 15).
-      * \returns the band assigned to packets.
-      */
-     uint16_t GetBandForPriority(uint8_t prio) const;
-     void ReportTimeoutStatistics () const;
-     void SetQSize(uint32_t size);
-   private:
-     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
-     Ptr<QueueDiscItem> DoDequeue() override;
-     Ptr<const QueueDiscItem> DoPeek() override;
-     bool CheckConfig() override;
-     void InitializeParams() override;
-     void RotatePriority();
-     uint16_t ttt;
-     Priomap m_prio2band; //!< Priority to band mapping
-     uint32_t m_rotationOffset;   // 轮转偏移量
-     uint32_t m_rotationOffset2; 
-     EventId m_rotationEvent;     // 轮转定时器
-     Time rotation_time;
-     Time m_rotationInterval;
-     uint32_t maxQueueSize;
-     std::vector<uint32_t> m_Bytesbudget; 
-     std::vector<double> remain_bytes;
-     Time m_timeoutThreshold;
-     uint32_t m_timeoutCount;
-     Time m_totalQueueDelay;
-     uint32_t m_dequeuedPackets;
-     Time m_pt;
-     uint32_t m_prefillpacket;
-     uint32_t qsize;
-
- };
- 
- /**
-  * Serialize the priomap to the given ostream
-  *
-  * \param os
-  * \param priomap
-  *
-  * \return std::ostream
-  */
-//  std::ostream& operator<<(std::ostream& os, const Priomap& priomap);
- 
-//  /**
-//   * Serialize from the given istream to this priomap.
-//   *
-//   * \param is
-//   * \param priomap
-//   *
-//   * \return std::istream
-//   */
-//  std::istream& operator>>(std::istream& is, Priomap& priomap);
- 
-//  ATTRIBUTE_HELPER_HEADER(Priomap);
- 
- } // namespace ns3
- 
- #endif /* PRIO_QUEUE_DISC_H */
- 
\ No newline at end of file
+#include "queue-disc.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/tags.h"
+#include "ns3/traced-callback.h"
+
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+/// Priority map
+typedef std::array<uint16_t, 16> Priomap;
+
+/**
+ * \ingroup traffic-control
+ *
+ * The Canlendar qdisc is a calendar queue made of a ring of NumSlots time
+ * slots. Every RotationInterval the current slot advances by one position and
+ * the byte budget of the slot that has just been served is reset. Prefill
+ * packets (and packets carrying no FlowTypeTag/DeadlineTag) are enqueued in
+ * the first slot, starting from the current one, that has enough byte budget
+ * left; decode packets are pushed forward by as many slots as their
+ * DeadlineTag allows. The current slot only accepts packets that can still be
+ * transmitted at the drain rate before the next rotation. Packets are dequeued
+ * from the first non-empty slot starting from the current one.
+ *
+ * The drain rate is read from the DataRate attribute of the device the queue
+ * disc is installed on, unless the DrainRate attribute is set. The byte budget
+ * of each slot is SlotCapacityBytes or, if not set, the number of bytes the
+ * link can drain in one RotationInterval. MaxSize limits the total number of
+ * bytes stored in the queue disc.
+ *
+ * On multi-queue devices, a sharded calendar can be obtained by installing an
+ * MqQueueDisc as root queue disc and a CanlendarQueueDisc as the child queue
+ * disc of each transmission queue. Each child then keeps its own calendar and
+ * is woken up by its own transmission queue, so that a stopped queue does not
+ * stall the others. Unless the DrainRate attribute is set, each child is
+ * drained at an equal share of the device rate.
+ *
+ * No event is scheduled to rotate the calendar: the current slot is derived
+ * from the simulation time whenever the queue disc is accessed, and the byte
+ * budgets of the slots left behind since the previous access are reset at
+ * that time. Hence, an idle queue disc costs no simulator events.
+ *
+ * The slots are lightweight packet lists owned by the queue disc itself (no
+ * internal queues nor child queue discs are used). A bitmap of non-empty slots
+ * makes enqueue O(1) and lets dequeue find the next slot to serve in
+ * O(slots/64).
+ *
+ * The FlowTypeTag, DeadlineTag, DelayTag and TimestampTag of a packet are
+ * resolved in a single walk of its packet tag list when the packet is
+ * enqueued. The resulting metadata is stored next to the packet in its slot
+ * and reused at dequeue time to update the statistics, so that no further tag
+ * lookups are needed.
+ *
+ * By default, the packets of a slot are served in arrival order. If the
+ * SlotOrdering attribute is set to Edf, each slot is kept as a binary heap
+ * ordered by the absolute deadline of its packets at this hop (the enqueue
+ * time plus the DeadlineTag value minus the delay accumulated at previous
+ * hops), so that a decode packet with a tight deadline does not wait behind
+ * bulk packets enqueued earlier in the same slot. Packets with no deadline
+ * are served after those with a deadline; ties are broken by arrival order.
+ *
+ * By default, the budget of a slot is consumed by every packet enqueued in the
+ * slot in the current round, even if the packet has already been dequeued.
+ * If the BudgetAccounting attribute is set to Credit, dequeuing a packet gives
+ * its bytes back to the budget of its slot (if the budget has not been reset
+ * in the meantime), so that a slot that has been drained early can admit more
+ * packets instead of spilling them to later slots. In both cases, the current
+ * slot only admits the packets that can be transmitted at the drain rate in
+ * the time left before the next rotation. The link capacity left unused in
+ * each rotation interval is reported by GetNIdleBytes and GetUtilization.
+ *
+ * The AdmissionMode attribute enables admission control for decode packets.
+ * If the slot a decode packet would be enqueued in cannot transmit it before
+ * its deadline, given the bytes already stored in the slot and the drain rate,
+ * the latest slot that can is used instead. If there is none, the packet is
+ * either dropped before enqueue (Drop) or served as best effort (Downgrade):
+ * it is enqueued in the slot served last among those with enough budget, and
+ * served after the packets with a deadline of that slot in EDF order, so that
+ * it does not take link capacity from packets that can still meet their
+ * deadline.
+ *
+ * The bytes stored in each slot, the packets moved to a later slot because a
+ * slot is full, the queueing delay of the packets of each flow type and the
+ * deadline slack of the dequeued packets are exported as trace sources. The
+ * queueing delays and the deadline slacks are also collected in log-scale
+ * histograms kept by the queue disc, from which tail percentiles can be read
+ * without enabling logging.
+ */
+class CanlendarQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief CanlendarQueueDisc constructor
+     */
+    CanlendarQueueDisc();
+
+    /**
+     * \brief Histogram of non-negative times with logarithmically spaced buckets
+     *
+     * Each power of two (in nanoseconds) is split into SUB_BUCKETS buckets of
+     * equal width, hence the percentiles are reported with a relative error
+     * lower than 1/SUB_BUCKETS. The buckets are allocated once, so recording a
+     * sample never allocates memory.
+     */
+    class LatencyHistogram
+    {
+      public:
+        LatencyHistogram();
+
+        /**
+         * Record a sample. Negative samples are recorded as zero.
+         *
+         * \param value the sample
+         */
+        void Record(Time value);
+
+        /**
+         * \return the number of recorded samples
+         */
+        uint64_t GetCount() const;
+
+        /**
+         * \return the largest recorded sample
+         */
+        Time GetMax() const;
+
+        /**
+         * Get the given percentile of the recorded samples, i.e., the upper
+         * bound of the bucket including the sample of rank ceil(q * count).
+         *
+         * \param q the percentile, as a value between 0 and 1
+         * \return the percentile, or zero if no sample has been recorded
+         */
+        Time GetPercentile(double q) const;
+
+        /**
+         * Discard all the recorded samples.
+         */
+        void Reset();
+
+      private:
+        static constexpr uint32_t SUB_BUCKETS = 16;             //!< Buckets per power of two
+        static constexpr uint32_t N_BUCKETS = 60 * SUB_BUCKETS; //!< Number of buckets
+
+        /**
+         * \param ns the sample in nanoseconds
+         * \return the index of the bucket including the sample
+         */
+        static uint32_t GetBucket(uint64_t ns);
+
+        /**
+         * \param bucket the bucket index
+         * \return the largest value (in nanoseconds) included in the bucket
+         */
+        static uint64_t GetUpperBound(uint32_t bucket);
+
+        std::array<uint64_t, N_BUCKETS> m_buckets; //!< Number of samples in each bucket
+        uint64_t m_count;                          //!< Number of recorded samples
+        uint64_t m_max;                            //!< Largest sample (ns)
+    };
+
+    /**
+     * TracedCallback signature for changes of the bytes stored in a slot.
+     *
+     * \param [in] slot the slot index
+     * \param [in] bytes the number of bytes now stored in the slot
+     */
+    typedef void (*SlotBytesTracedCallback)(uint32_t slot, uint32_t bytes);
+
+    /**
+     * TracedCallback signature for packets that do not fit in a slot and are
+     * moved to the next one.
+     *
+     * \param [in] item the packet
+     * \param [in] slot the slot the packet did not fit in
+     */
+    typedef void (*SlotOverflowTracedCallback)(Ptr<const QueueDiscItem> item, uint32_t slot);
+
+    /**
+     * TracedCallback signature for the queueing delay of dequeued packets
+     * carrying a FlowTypeTag.
+     *
+     * \param [in] item the packet
+     * \param [in] flowType the flow type of the packet
+     * \param [in] delay the time elapsed since the packet was first enqueued
+     */
+    typedef void (*QueueDelayTracedCallback)(Ptr<const QueueDiscItem> item,
+                                             FlowTypeTag::FlowType flowType,
+                                             Time delay);
+
+    /**
+     * TracedCallback signature for the deadline slack of dequeued packets
+     * carrying a DeadlineTag.
+     *
+     * \param [in] item the packet
+     * \param [in] slack the time left before the deadline at this hop
+     *                   (negative if the deadline has been missed)
+     */
+    typedef void (*DeadlineSlackTracedCallback)(Ptr<const QueueDiscItem> item, Time slack);
+
+    /// Order in which the packets of a slot are served
+    enum SlotOrdering
+    {
+        FIFO, //!< Arrival order
+        EDF   //!< Earliest deadline first
+    };
+
+    /// How the bytes assigned to a slot in the current round are accounted for
+    enum BudgetAccounting
+    {
+        ENQUEUED_BYTES, //!< All the bytes enqueued in the slot in the current round
+        CREDIT          //!< The bytes enqueued in the current round and not yet dequeued
+    };
+
+    /// Treatment of the decode packets that cannot be served before their deadline
+    enum AdmissionMode
+    {
+        ADMIT_ALL,  //!< Enqueue them in the first slot with enough budget
+        EARLY_DROP, //!< Drop them before enqueue
+        DOWNGRADE   //!< Enqueue them as best effort packets
+    };
+
+    ~CanlendarQueueDisc() override;
+
+    /**
+     * Set the band (class) assigned to packets with specified priority.
+     *
+     * \param prio the priority of packets (a value between 0 and 15).
+     * \param band the band assigned to packets.
+     */
+    void SetBandForPriority(uint8_t prio, uint16_t band);
+
+    /**
+     * Get the band (class) assigned to packets with specified priority.
+     *
+     * \param prio the priority of packets (a value between 0 and 15).
+     * \returns the band assigned to packets.
+     */
+    uint16_t GetBandForPriority(uint8_t prio) const;
+
+    /**
+     * Print the queueing delay and timeout statistics of decode and prefill
+     * packets to the standard output.
+     */
+    void ReportTimeoutStatistics() const;
+
+    /**
+     * \return the number of slots of the calendar
+     */
+    uint32_t GetNSlots() const;
+
+    /**
+     * \param slot the slot index
+     * \return the number of packets stored in the given slot
+     */
+    uint32_t GetSlotNPackets(uint32_t slot) const;
+
+    /**
+     * \param slot the slot index
+     * \return the number of bytes stored in the given slot
+     */
+    uint32_t GetSlotNBytes(uint32_t slot) const;
+
+    /**
+     * \return the index of the slot currently being served
+     */
+    uint32_t GetCurrentSlot() const;
+
+    /**
+     * \return the rate at which the slots are drained
+     */
+    DataRate GetDrainRate() const;
+
+    /**
+     * \return the number of bytes each slot can be assigned per round
+     */
+    uint64_t GetSlotCapacity() const;
+
+    /**
+     * \param flowType the flow type
+     * \return the histogram of the queueing delay of the packets of the given
+     *         flow type
+     */
+    const LatencyHistogram& GetQueueDelayHistogram(FlowTypeTag::FlowType flowType) const;
+
+    /**
+     * \return the histogram of the deadline slack of the packets dequeued
+     *         before their deadline
+     */
+    const LatencyHistogram& GetDeadlineSlackHistogram() const;
+
+    /**
+     * \return the histogram of the lateness of the packets dequeued after
+     *         their deadline
+     */
+    const LatencyHistogram& GetDeadlineMissHistogram() const;
+
+    /**
+     * \return the number of times a packet did not fit in a slot and was
+     *         moved to the next one
+     */
+    uint64_t GetNSlotOverflows() const;
+
+    /**
+     * \return the number of decode packets served as best effort because their
+     *         deadline could not be met
+     */
+    uint64_t GetNDowngradedPackets() const;
+
+    /**
+     * \return the number of bytes the drain rate allowed to transmit in the
+     *         rotation intervals completed so far that were not dequeued
+     */
+    uint64_t GetNIdleBytes() const;
+
+    /**
+     * \return the fraction of the bytes the drain rate allowed to transmit in
+     *         the rotation intervals completed so far that were dequeued
+     */
+    double GetUtilization() const;
+
+    // Reasons for dropping packets
+    static constexpr const char* ALL_SLOTS_FULL_DROP =
+        "No calendar slot has enough budget"; //!< No slot could accept the packet
+    static constexpr const char* LIMIT_EXCEEDED_DROP =
+        "Queue disc limit exceeded"; //!< Packet dropped due to queue disc limit exceeded
+    static constexpr const char* DEADLINE_UNREACHABLE_DROP =
+        "Deadline cannot be met"; //!< No slot can serve the decode packet in time
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Metadata of a packet, resolved from its tags once at enqueue time
+     */
+    struct ItemInfo
+    {
+        bool hasFlowType{false};          //!< Whether the packet has a FlowTypeTag
+        FlowTypeTag::FlowType flowType{}; //!< The flow type
+        bool hasDeadline{false};          //!< Whether the packet has a DeadlineTag
+        double deadline{0};               //!< The deadline (s)
+        bool hasDelay{false};             //!< Whether the packet has a DelayTag
+        Time delay;                       //!< The delay accumulated at previous hops
+        Time timestamp;                   //!< The time the packet was first enqueued
+        Time expiry{Time::Max()};         //!< The absolute deadline at this hop
+        bool bestEffort{false};           //!< Whether the deadline is ignored when serving
+    };
+
+    /**
+     * \brief A packet stored in a slot, along with its metadata
+     */
+    struct SlotEntry
+    {
+        Ptr<QueueDiscItem> item; //!< The packet
+        ItemInfo info;           //!< The metadata of the packet
+        uint64_t seq;            //!< Arrival sequence number
+        uint64_t round;          //!< Round of the slot the packet was admitted in
+    };
+
+    /**
+     * Heap comparator used to keep the slots ordered by absolute deadline.
+     *
+     * \param a the first entry
+     * \param b the second entry
+     * \return true if a has to be served after b
+     */
+    static bool ServedAfter(const SlotEntry& a, const SlotEntry& b);
+
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    Ptr<const QueueDiscItem> DoPeek() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \return the number of rotations performed since initialization
+     */
+    uint64_t GetEpoch() const;
+
+    /**
+     * Bring the current slot up to date with the simulation time and reset
+     * the byte budget of the slots that have been served since the previous
+     * update.
+     */
+    void UpdateRotation();
+
+    /**
+     * Resolve the metadata of the given item by walking its packet tag list
+     * once. A TimestampTag set to the current time is added if the packet
+     * does not carry one.
+     *
+     * \param item the item
+     * \return the metadata of the item
+     */
+    ItemInfo ClassifyItem(Ptr<QueueDiscItem> item) const;
+
+    /**
+     * Store the given item at the tail of the given slot.
+     *
+     * \param slot the slot index
+     * \param item the item to store
+     * \param info the metadata of the item
+     */
+    void EnqueueIntoSlot(uint32_t slot, Ptr<QueueDiscItem> item, const ItemInfo& info);
+
+    /**
+     * \param slot the slot index
+     * \param item the item
+     * \param remainBytes the bytes the current slot can still send before the
+     *        next rotation
+     * \return true if the given slot has enough budget left for the given item
+     */
+    bool CanAdmit(uint32_t slot, Ptr<QueueDiscItem> item, double remainBytes) const;
+
+    /**
+     * Estimate the time the given item would be transmitted by if it were
+     * enqueued in the given slot, given the bytes already stored in the slot
+     * and the drain rate.
+     *
+     * \param slot the slot index
+     * \param item the item
+     * \return the estimated transmission end time
+     */
+    Time GetFinishTime(uint32_t slot, Ptr<QueueDiscItem> item) const;
+
+    /**
+     * Find the latest slot that can admit the given item and serve it before
+     * its deadline.
+     *
+     * \param item the item
+     * \param info the metadata of the item
+     * \param remainBytes the bytes the current slot can still send before the
+     *        next rotation
+     * \return the slot index, or the number of slots if no slot is feasible
+     */
+    uint32_t FindFeasibleSlot(Ptr<QueueDiscItem> item,
+                              const ItemInfo& info,
+                              double remainBytes) const;
+
+    /**
+     * Find the first non-empty slot, scanning the ring from the given slot.
+     *
+     * \param from the slot to start the search from
+     * \return the index of the first non-empty slot, or the number of slots if
+     *         the calendar is empty
+     */
+    uint32_t FindNonEmptySlot(uint32_t from) const;
+
+    Priomap m_prio2band;                 //!< Priority to band mapping
+    uint32_t m_rotationOffset;           //!< Slot currently being served
+    Time m_startTime;                    //!< Time the calendar was initialized
+    uint64_t m_epoch;                    //!< Number of rotations performed so far
+    Time rotation_time;                  //!< Time of the last rotation
+    Time m_rotationInterval;             //!< Time interval between rotations
+    std::vector<uint64_t> m_Bytesbudget; //!< Budget consumed in each slot in the current round
+    Time m_timeoutThreshold;             //!< Queueing delay above which a decode packet times out
+    uint32_t m_timeoutCount;             //!< Number of decode packets that timed out
+    Time m_totalQueueDelay;              //!< Total queueing delay of decode packets
+    uint32_t m_dequeuedPackets;          //!< Number of dequeued decode packets
+    Time m_pt;                           //!< Total queueing delay of prefill packets
+    uint32_t m_prefillpacket;            //!< Number of dequeued prefill packets
+    uint32_t m_nSlots;                   //!< Number of slots of the calendar
+    uint32_t m_slotCapacityBytes;        //!< Configured per-slot budget (0 to derive it)
+    DataRate m_drainRate;                //!< Configured drain rate (0 to read it from the device)
+    uint64_t m_slotCapacity;             //!< Per-slot budget in use
+    DataRate m_linkRate;                 //!< Drain rate in use
+    SlotOrdering m_slotOrdering;         //!< Order in which the packets of a slot are served
+    AdmissionMode m_admissionMode;       //!< Treatment of the packets missing their deadline
+    BudgetAccounting m_budgetAccounting; //!< How the slot budgets are accounted for
+    uint64_t m_epochCapacity;            //!< Bytes the drain rate allows to transmit per rotation
+    uint64_t m_epochDequeuedBytes;       //!< Bytes dequeued in the current rotation interval
+    uint64_t m_idleBytes;                //!< Bytes not dequeued in the completed rotation intervals
+    uint64_t m_seq;                      //!< Sequence number of the next enqueued packet
+
+    std::vector<std::deque<SlotEntry>> m_slots; //!< Packets stored in each slot
+    std::vector<uint32_t> m_slotBytes;          //!< Bytes stored in each slot
+    std::vector<uint64_t> m_nonEmptySlots;      //!< Bitmap of the non-empty slots
+    std::vector<uint64_t> m_slotRounds;         //!< Number of budget resets of each slot
+
+    std::array<LatencyHistogram, 2> m_queueDelay; //!< Queueing delay for each flow type
+    LatencyHistogram m_deadlineSlack;             //!< Slack of the packets meeting the deadline
+    LatencyHistogram m_deadlineMiss;              //!< Lateness of the packets missing the deadline
+    uint64_t m_nSlotOverflows;                    //!< Number of packets moved to a later slot
+    uint64_t m_nDowngradedPackets;                //!< Number of packets served as best effort
+
+    TracedCallback<uint32_t, uint32_t> m_slotBytesTrace; //!< Bytes stored in a slot
+    /// Packet moved to a later slot
+    TracedCallback<Ptr<const QueueDiscItem>, uint32_t> m_slotOverflowTrace;
+    /// Queueing delay of a dequeued packet
+    TracedCallback<Ptr<const QueueDiscItem>, FlowTypeTag::FlowType, Time> m_queueDelayTrace;
+    /// Deadline slack of a dequeued packet
+    TracedCallback<Ptr<const QueueDiscItem>, Time> m_deadlineSlackTrace;
+};
+
+} // namespace ns3
+
+#endif /* CALENDAR_QUEUE_DISC_H */
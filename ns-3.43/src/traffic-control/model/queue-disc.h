@@ -561,6 +561,26 @@ class QueueDisc : public Object
      */
     bool Mark(Ptr<QueueDiscItem> item, const char* reason);
 
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet enqueue
+     * \param item item that was enqueued
+     * This method is automatically called for packets enqueued in internal
+     * queues or child queue discs. Subclasses storing packets in their own
+     * data structures must call it to record that a packet was enqueued.
+     */
+    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dequeue
+     * \param item item that was dequeued
+     * This method is automatically called for packets dequeued from internal
+     * queues or child queue discs. Subclasses storing packets in their own
+     * data structures must call it to record that a packet was dequeued.
+     */
+    void PacketDequeued(Ptr<const QueueDiscItem> item);
+
   private:
     /**
      * This function actually enqueues a packet into the queue disc.
@@ -659,20 +679,6 @@ class QueueDisc : public Object
      */
     bool Transmit(Ptr<QueueDiscItem> item);
 
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet enqueue
-     * \param item item that was enqueued
-     */
-    void PacketEnqueued(Ptr<const QueueDiscItem> item);
-
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet dequeue
-     * \param item item that was dequeued
-     */
-    void PacketDequeued(Ptr<const QueueDiscItem> item);
-
     /// Default quota (as in /proc/sys/net/core/dev_weight)
     static const uint32_t DEFAULT_QUOTA = 64;
 
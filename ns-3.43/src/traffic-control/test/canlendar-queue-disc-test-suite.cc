@@ -0,0 +1,915 @@
+#include "ns3/canlendar-queue-disc.h"
+#include "ns3/data-rate.h"
+#include "ns3/enum.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tags.h"
+#include "ns3/test.h"
+#include "ns3/timestamp-tag.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Canlendar Queue Disc Test Item
+ */
+class CanlendarQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param addr the address
+     */
+    CanlendarQueueDiscTestItem(Ptr<Packet> p, const Address& addr);
+    void AddHeader() override;
+    bool Mark() override;
+};
+
+CanlendarQueueDiscTestItem::CanlendarQueueDiscTestItem(Ptr<Packet> p, const Address& addr)
+    : QueueDiscItem(p, addr, 0)
+{
+}
+
+void
+CanlendarQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+CanlendarQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Reference class-based calendar queue disc
+ *
+ * This is the original implementation of the CanlendarQueueDisc, which stores
+ * the packets of each slot in a child FifoQueueDisc and probes the children
+ * linearly. It is used to check that the native calendar engine makes the
+ * same enqueue and dequeue decisions.
+ */
+class ClassBasedCanlendarQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    ClassBasedCanlendarQueueDisc();
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+    /// Advance the current band
+    void RotatePriority();
+
+    uint32_t m_rotationOffset;           //!< Band currently being served
+    Time rotation_time;                  //!< Time of the last rotation
+    Time m_rotationInterval;             //!< Rotation interval
+    uint32_t m_nBands;                   //!< Number of bands
+    uint32_t m_bandCapacity;             //!< Per-band byte budget
+    DataRate m_drainRate;                //!< Drain rate
+    std::vector<uint32_t> m_Bytesbudget; //!< Bytes admitted to each band
+};
+
+TypeId
+ClassBasedCanlendarQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ClassBasedCanlendarQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<ClassBasedCanlendarQueueDisc>()
+            .AddAttribute("RotationInterval",
+                          "Time interval for priority rotation",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&ClassBasedCanlendarQueueDisc::m_rotationInterval),
+                          MakeTimeChecker())
+            .AddAttribute("NumSlots",
+                          "The number of bands",
+                          UintegerValue(200),
+                          MakeUintegerAccessor(&ClassBasedCanlendarQueueDisc::m_nBands),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SlotCapacityBytes",
+                          "The maximum number of bytes each band can be assigned per round.",
+                          UintegerValue(100000),
+                          MakeUintegerAccessor(&ClassBasedCanlendarQueueDisc::m_bandCapacity),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("DrainRate",
+                          "The rate at which the bands are drained.",
+                          DataRateValue(DataRate("1Gbps")),
+                          MakeDataRateAccessor(&ClassBasedCanlendarQueueDisc::m_drainRate),
+                          MakeDataRateChecker());
+    return tid;
+}
+
+ClassBasedCanlendarQueueDisc::ClassBasedCanlendarQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES),
+      m_rotationOffset(0)
+{
+}
+
+bool
+ClassBasedCanlendarQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    uint32_t nBands = GetNQueueDiscClasses();
+    uint32_t packetSize = item->GetPacket()->GetSize();
+    uint32_t csize = GetQueueDiscClass(m_rotationOffset)->GetQueueDisc()->GetNBytes();
+
+    FlowTypeTag flowtype;
+    DeadlineTag ddl;
+    bool hastypetag = item->GetPacket()->PeekPacketTag(flowtype);
+    bool hasddltag = item->GetPacket()->PeekPacketTag(ddl);
+    for (uint32_t i = 0; i < nBands; i++)
+    {
+        Time current_enqueue_time = Simulator::Now();
+        uint32_t band = (i + m_rotationOffset) % nBands;
+        if (hastypetag && hasddltag && flowtype.GetType() == FlowTypeTag::DECODE)
+        {
+            DelayTag delaytag;
+            uint16_t backward = static_cast<int>(
+                floor((ddl.GetDeadline() - (item->GetPacket()->PeekPacketTag(delaytag)
+                                                ? delaytag.GetTimestamp().GetSeconds()
+                                                : 0)) /
+                      m_rotationInterval.GetSeconds()));
+            band = (i + m_rotationOffset + backward - 1) % nBands;
+        }
+        Time remain_time = m_rotationInterval - (current_enqueue_time - rotation_time);
+        double remain_bytes = remain_time.GetSeconds() * m_drainRate.GetBitRate() / 8 - csize;
+        if (m_Bytesbudget[band] + item->GetSize() <= m_bandCapacity &&
+            (band != m_rotationOffset || packetSize <= remain_bytes))
+        {
+            bool retval = GetQueueDiscClass(band)->GetQueueDisc()->Enqueue(item);
+            m_Bytesbudget[band] += item->GetSize();
+            return retval;
+        }
+    }
+    DropBeforeEnqueue(item, CanlendarQueueDisc::ALL_SLOTS_FULL_DROP);
+    return false;
+}
+
+Ptr<QueueDiscItem>
+ClassBasedCanlendarQueueDisc::DoDequeue()
+{
+    Ptr<QueueDiscItem> item;
+    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+    {
+        uint32_t band = (i + m_rotationOffset) % GetNQueueDiscClasses();
+        if ((item = GetQueueDiscClass(band)->GetQueueDisc()->Dequeue()))
+        {
+            return item;
+        }
+    }
+    return item;
+}
+
+bool
+ClassBasedCanlendarQueueDisc::CheckConfig()
+{
+    ObjectFactory factory;
+    factory.SetTypeId("ns3::FifoQueueDisc");
+    factory.Set("MaxSize", QueueSizeValue(QueueSize("1000000p")));
+    for (uint32_t i = 0; i < m_nBands; i++)
+    {
+        Ptr<QueueDisc> qd = factory.Create<QueueDisc>();
+        qd->Initialize();
+        Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass>();
+        c->SetQueueDisc(qd);
+        AddQueueDiscClass(c);
+    }
+    return true;
+}
+
+void
+ClassBasedCanlendarQueueDisc::InitializeParams()
+{
+    m_Bytesbudget.resize(GetNQueueDiscClasses(), 0);
+    Simulator::Schedule(m_rotationInterval, &ClassBasedCanlendarQueueDisc::RotatePriority, this);
+}
+
+void
+ClassBasedCanlendarQueueDisc::RotatePriority()
+{
+    m_Bytesbudget[m_rotationOffset] = 0;
+    rotation_time = Simulator::Now();
+    m_rotationOffset = (m_rotationOffset + 1) % GetNQueueDiscClasses();
+    Simulator::Schedule(m_rotationInterval, &ClassBasedCanlendarQueueDisc::RotatePriority, this);
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Canlendar Queue Disc Test Case
+ */
+class CanlendarQueueDiscTestCase : public TestCase
+{
+  public:
+    CanlendarQueueDiscTestCase();
+    void DoRun() override;
+};
+
+CanlendarQueueDiscTestCase::CanlendarQueueDiscTestCase()
+    : TestCase("Sanity check on the canlendar queue disc implementation")
+{
+}
+
+/**
+ * Create a packet carrying the FlowTypeTag and DeadlineTag used by the
+ * calendar queue disc
+ *
+ * \param size the packet size
+ * \param type the flow type
+ * \param deadline the deadline (s)
+ * \return the packet
+ */
+static Ptr<Packet>
+CreateTaggedPacket(uint32_t size, FlowTypeTag::FlowType type, double deadline)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    FlowTypeTag flowtype;
+    flowtype.SetType(type);
+    DeadlineTag ddl;
+    ddl.SetDeadline(deadline);
+    p->AddPacketTag(flowtype);
+    p->AddPacketTag(ddl);
+    return p;
+}
+
+void
+CanlendarQueueDiscTestCase::DoRun()
+{
+    Ptr<CanlendarQueueDisc> qdisc;
+    Ptr<QueueDiscItem> item;
+    Address dest;
+
+    /*
+     * Test 1: packets are stored in the slots selected by their flow type
+     */
+    qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("SlotCapacityBytes",
+                                                           UintegerValue(3000),
+                                                           "DrainRate",
+                                                           StringValue("1Gbps"),
+                                                           "RotationInterval",
+                                                           StringValue("10ms"));
+    qdisc->Initialize();
+
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNSlots(), 200, "Unexpected number of slots");
+
+    // three prefill packets fill the budget of slot 0, the next one spills to slot 1
+    uint64_t first = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        Ptr<Packet> p = CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.1);
+        first = (i == 0 ? p->GetUid() : first);
+        NS_TEST_ASSERT_MSG_EQ(qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(p, dest)),
+                              true,
+                              "Prefill packet " << i << " should be enqueued");
+    }
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(0), 3, "Slot 0 should hold 3 packets");
+    Ptr<Packet> big = CreateTaggedPacket(1500, FlowTypeTag::PREFILL, 0.1);
+    qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(big, dest));
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(1), 1, "Slot 1 should hold 1 packet");
+
+    // a decode packet with a 50ms deadline is deferred by 5 slots, minus one
+    Ptr<Packet> decode = CreateTaggedPacket(500, FlowTypeTag::DECODE, 0.05);
+    qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(decode, dest));
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(4), 1, "The decode packet should be deferred");
+
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNPackets(), 5, "The queue disc should hold 5 packets");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNBytes(), 5000, "The queue disc should hold 5000 bytes");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Peek()->GetPacket()->GetUid(),
+                          first,
+                          "The peeked packet is not the one we expected");
+
+    item = qdisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->GetUid(),
+                          first,
+                          "The dequeued packet is not the one we expected");
+    TimestampTag tsTag;
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->PeekPacketTag(tsTag),
+                          true,
+                          "Enqueued packets should carry a timestamp tag");
+    DelayTag delayTag;
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->PeekPacketTag(delayTag),
+                          true,
+                          "Dequeued packets should carry a delay tag");
+    qdisc->Dequeue();
+    qdisc->Dequeue();
+    item = qdisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->GetUid(),
+                          big->GetUid(),
+                          "The packet in slot 1 should follow those in slot 0");
+    item = qdisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->GetUid(),
+                          decode->GetUid(),
+                          "The deferred decode packet should be dequeued last");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Dequeue(), nullptr, "The queue disc should be empty");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Peek(), nullptr, "The queue disc should be empty");
+
+    /*
+     * Test 2: packets that do not fit any slot are dropped and accounted for
+     */
+    Ptr<Packet> huge = CreateTaggedPacket(4000, FlowTypeTag::PREFILL, 0.1);
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(huge, dest)),
+                          false,
+                          "A packet larger than the slot budget should be dropped");
+    QueueDisc::Stats st = qdisc->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(st.GetNDroppedPackets(CanlendarQueueDisc::ALL_SLOTS_FULL_DROP),
+                          1,
+                          "The drop should be recorded with its reason");
+    NS_TEST_ASSERT_MSG_EQ(st.nTotalEnqueuedPackets, 5, "Unexpected number of enqueued packets");
+    NS_TEST_ASSERT_MSG_EQ(st.nTotalDequeuedPackets, 5, "Unexpected number of dequeued packets");
+
+    /*
+     * Test 3: the slot capacity is derived from the drain rate and MaxSize
+     * limits the total size of the queue disc
+     */
+    qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("DrainRate",
+                                                           StringValue("8Mbps"),
+                                                           "RotationInterval",
+                                                           StringValue("10ms"),
+                                                           "NumSlots",
+                                                           UintegerValue(64),
+                                                           "MaxSize",
+                                                           StringValue("4000B"));
+    qdisc->Initialize();
+
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNSlots(), 64, "Unexpected number of slots");
+    NS_TEST_ASSERT_MSG_EQ(Simulator::IsFinished(), true, "No rotation event should be scheduled");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetDrainRate(), DataRate("8Mbps"), "Unexpected drain rate");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotCapacity(), 10000, "Unexpected slot capacity");
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000), dest));
+    }
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(0), 4, "Slot 0 should hold 4 packets");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000),
+                                                                            dest)),
+                          false,
+                          "The packet should be dropped because the queue disc is full");
+    st = qdisc->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(st.GetNDroppedPackets(CanlendarQueueDisc::LIMIT_EXCEEDED_DROP),
+                          1,
+                          "The drop should be recorded with its reason");
+
+    // the slot capacity derived for a fast link exceeds 32 bits
+    qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("DrainRate",
+                                                           StringValue("100Gbps"),
+                                                           "RotationInterval",
+                                                           StringValue("1s"));
+    qdisc->Initialize();
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotCapacity(),
+                          12500000000ULL,
+                          "Unexpected slot capacity at 100Gbps");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000),
+                                                                            dest)),
+                          true,
+                          "The packet should fit the slot budget");
+    qdisc->Dispose();
+
+    /*
+     * Test 4: in EDF order, the packets of a slot are served by absolute deadline
+     */
+    for (auto ordering : {CanlendarQueueDisc::FIFO, CanlendarQueueDisc::EDF})
+    {
+        qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("DrainRate",
+                                                               StringValue("1Gbps"),
+                                                               "RotationInterval",
+                                                               StringValue("10ms"),
+                                                               "SlotOrdering",
+                                                               EnumValue(ordering));
+        qdisc->Initialize();
+
+        std::vector<Ptr<Packet>> packets{CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.3),
+                                         Create<Packet>(1000),
+                                         CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.1),
+                                         CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.2),
+                                         CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.1),
+                                         CreateTaggedPacket(1000, FlowTypeTag::DECODE, 0.05)};
+        // the decode packet already waited 40ms, hence it falls in the current slot
+        DelayTag delaytag;
+        delaytag.SetTimestamp(MilliSeconds(40));
+        packets[5]->AddPacketTag(delaytag);
+        for (const auto& p : packets)
+        {
+            qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(p, dest));
+        }
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(0), 6, "Slot 0 should hold 6 packets");
+
+        std::vector<uint32_t> order{0, 1, 2, 3, 4, 5};
+        if (ordering == CanlendarQueueDisc::EDF)
+        {
+            order = {5, 2, 4, 3, 0, 1};
+        }
+        for (uint32_t i : order)
+        {
+            NS_TEST_ASSERT_MSG_EQ(qdisc->Peek()->GetPacket()->GetUid(),
+                                  packets[i]->GetUid(),
+                                  "The peeked packet is not the one we expected");
+            item = qdisc->Dequeue();
+            NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->GetUid(),
+                                  packets[i]->GetUid(),
+                                  "The dequeued packet is not the one we expected");
+        }
+        NS_TEST_ASSERT_MSG_EQ(qdisc->Dequeue(), nullptr, "The queue disc should be empty");
+    }
+
+    /*
+     * Test 5: the trace sources and the histograms report slot overflows,
+     * queueing delays and deadline slacks
+     */
+    qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("SlotCapacityBytes",
+                                                           UintegerValue(2000),
+                                                           "DrainRate",
+                                                           StringValue("1Gbps"),
+                                                           "RotationInterval",
+                                                           StringValue("10ms"));
+    qdisc->Initialize();
+
+    uint32_t nOverflows = 0;
+    uint32_t nDelays = 0;
+    uint32_t nMisses = 0;
+    std::vector<uint32_t> slotBytes(qdisc->GetNSlots(), 0);
+    qdisc->TraceConnectWithoutContext(
+        "SlotOverflow",
+        Callback<void, Ptr<const QueueDiscItem>, uint32_t>(
+            [&](Ptr<const QueueDiscItem>, uint32_t) { nOverflows++; }));
+    qdisc->TraceConnectWithoutContext(
+        "SlotBytes",
+        Callback<void, uint32_t, uint32_t>(
+            [&](uint32_t slot, uint32_t bytes) { slotBytes[slot] = bytes; }));
+    qdisc->TraceConnectWithoutContext(
+        "QueueDelay",
+        Callback<void, Ptr<const QueueDiscItem>, FlowTypeTag::FlowType, Time>(
+            [&](Ptr<const QueueDiscItem>, FlowTypeTag::FlowType, Time) { nDelays++; }));
+    qdisc->TraceConnectWithoutContext(
+        "DeadlineSlack",
+        Callback<void, Ptr<const QueueDiscItem>, Time>(
+            [&](Ptr<const QueueDiscItem>, Time slack) { nMisses += slack.IsNegative(); }));
+
+    // slot 0 can hold two prefill packets, the third one and the decode
+    // packet (deferred to slot 0 by its 15ms deadline) overflow to slot 1
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(
+            CreateTaggedPacket(1000, FlowTypeTag::PREFILL, 0.1),
+            dest));
+    }
+    qdisc->Enqueue(
+        Create<CanlendarQueueDiscTestItem>(CreateTaggedPacket(500, FlowTypeTag::DECODE, 0.015),
+                                           dest));
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNSlotOverflows(), 2, "Two packets should have overflowed");
+    NS_TEST_ASSERT_MSG_EQ(nOverflows, 2, "Two overflows should have been traced");
+    NS_TEST_ASSERT_MSG_EQ(slotBytes[0], 2000, "Unexpected traced bytes of slot 0");
+    NS_TEST_ASSERT_MSG_EQ(slotBytes[1], 1500, "Unexpected traced bytes of slot 1");
+
+    // a decode packet that already waited longer than its deadline at
+    // previous hops is dequeued 5ms late
+    Simulator::Schedule(MilliSeconds(5), [&]() {
+        Ptr<Packet> late = CreateTaggedPacket(500, FlowTypeTag::DECODE, 0.015);
+        DelayTag delaytag;
+        delaytag.SetTimestamp(MilliSeconds(20));
+        late->AddPacketTag(delaytag);
+        qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(late, dest));
+        while (qdisc->Dequeue())
+        {
+        }
+    });
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(slotBytes[0], 0, "Slot 0 should be traced as empty");
+    NS_TEST_ASSERT_MSG_EQ(slotBytes[1], 0, "Slot 1 should be traced as empty");
+    NS_TEST_ASSERT_MSG_EQ(nDelays, 5, "The delay of all packets should have been traced");
+    NS_TEST_ASSERT_MSG_EQ(nMisses, 1, "One deadline miss should have been traced");
+    const auto& prefillDelay = qdisc->GetQueueDelayHistogram(FlowTypeTag::PREFILL);
+    NS_TEST_ASSERT_MSG_EQ(prefillDelay.GetCount(), 3, "Unexpected number of prefill samples");
+    NS_TEST_ASSERT_MSG_EQ(prefillDelay.GetPercentile(0.99),
+                          MilliSeconds(5),
+                          "Unexpected prefill queueing delay");
+    const auto& decodeDelay = qdisc->GetQueueDelayHistogram(FlowTypeTag::DECODE);
+    NS_TEST_ASSERT_MSG_EQ(decodeDelay.GetCount(), 2, "Unexpected number of decode samples");
+    NS_TEST_ASSERT_MSG_EQ(decodeDelay.GetPercentile(0.5),
+                          Time(0),
+                          "The late decode packet should not have waited");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetDeadlineSlackHistogram().GetCount(),
+                          4,
+                          "Four packets should have met their deadline");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetDeadlineMissHistogram().GetCount(),
+                          1,
+                          "One packet should have missed its deadline");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetDeadlineMissHistogram().GetPercentile(0.5),
+                          MilliSeconds(5),
+                          "Unexpected lateness of the late packet");
+
+    /*
+     * Test 6: admission control moves decode packets that would miss their
+     * deadline to an earlier slot, or drops or downgrades them to the last
+     * slot if no slot can serve them in time. Each slot drains 2000 bytes per rotation and a
+     * deadline of 20ms defers decode packets to slot 1.
+     */
+    for (auto mode : {CanlendarQueueDisc::ADMIT_ALL,
+                      CanlendarQueueDisc::EARLY_DROP,
+                      CanlendarQueueDisc::DOWNGRADE})
+    {
+        qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("DrainRate",
+                                                               StringValue("1600kbps"),
+                                                               "RotationInterval",
+                                                               StringValue("10ms"),
+                                                               "AdmissionMode",
+                                                               EnumValue(mode));
+        qdisc->Initialize();
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotCapacity(), 2000, "Unexpected slot capacity");
+
+        std::vector<bool> enqueued;
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            enqueued.push_back(qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(
+                CreateTaggedPacket(1000, FlowTypeTag::DECODE, 0.02),
+                dest)));
+        }
+
+        // without admission control, the packets that do not fit in slot 1
+        // are served in slots 2 and 3, i.e., after their deadline
+        std::vector<uint32_t> expected{0, 2, 2, 1};
+        if (mode == CanlendarQueueDisc::EARLY_DROP)
+        {
+            expected = {2, 2, 0, 0};
+        }
+        else if (mode == CanlendarQueueDisc::DOWNGRADE)
+        {
+            // the downgraded packet is moved to the slot served last
+            expected = {2, 2, 0, 0};
+            NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(qdisc->GetNSlots() - 1),
+                                  1,
+                                  "The downgraded packet should be in the last slot");
+        }
+        for (uint32_t slot = 0; slot < expected.size(); slot++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(qdisc->GetSlotNPackets(slot),
+                                  expected[slot],
+                                  "Unexpected number of packets in slot " << slot);
+        }
+        NS_TEST_ASSERT_MSG_EQ(enqueued[4],
+                              (mode != CanlendarQueueDisc::EARLY_DROP),
+                              "Only early drop should reject the last packet");
+        NS_TEST_ASSERT_MSG_EQ(
+            qdisc->GetStats().GetNDroppedPackets(CanlendarQueueDisc::DEADLINE_UNREACHABLE_DROP),
+            (mode == CanlendarQueueDisc::EARLY_DROP ? 1 : 0),
+            "Unexpected number of packets dropped because of their deadline");
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetNDowngradedPackets(),
+                              (mode == CanlendarQueueDisc::DOWNGRADE ? 1 : 0),
+                              "Unexpected number of downgraded packets");
+    }
+
+    /*
+     * Test 7: with credit-based accounting, the packets dequeued from the
+     * current slot give their bytes back to its budget. In both modes, the
+     * link capacity left unused in each rotation interval is accounted for.
+     */
+    for (auto accounting : {CanlendarQueueDisc::ENQUEUED_BYTES, CanlendarQueueDisc::CREDIT})
+    {
+        qdisc = CreateObjectWithAttributes<CanlendarQueueDisc>("DrainRate",
+                                                               StringValue("1600kbps"),
+                                                               "RotationInterval",
+                                                               StringValue("10ms"),
+                                                               "BudgetAccounting",
+                                                               EnumValue(accounting));
+        qdisc->Initialize();
+        Time start = Simulator::Now();
+
+        // slot 0 is filled at the beginning of the rotation interval and drained
+        // 1ms later; then, another packet arrives
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000), dest));
+        }
+        uint32_t slot0 = 0;
+        uint32_t slot1 = 0;
+        Simulator::Schedule(MilliSeconds(1), [&]() {
+            qdisc->Dequeue();
+            qdisc->Dequeue();
+            qdisc->Enqueue(Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000), dest));
+            slot0 = qdisc->GetSlotNPackets(0);
+            slot1 = qdisc->GetSlotNPackets(1);
+        });
+        Simulator::Schedule(MilliSeconds(25), [&]() { qdisc->Peek(); });
+        Simulator::Run();
+
+        NS_TEST_ASSERT_MSG_EQ(slot0,
+                              (accounting == CanlendarQueueDisc::CREDIT ? 1 : 0),
+                              "Unexpected number of packets in slot 0");
+        NS_TEST_ASSERT_MSG_EQ(slot1,
+                              (accounting == CanlendarQueueDisc::CREDIT ? 0 : 1),
+                              "Unexpected number of packets in slot 1");
+        // two rotation intervals have elapsed and 2000 bytes out of 4000 have
+        // been dequeued
+        NS_TEST_ASSERT_MSG_EQ(Simulator::Now() - start, MilliSeconds(25), "Unexpected time");
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetNIdleBytes(), 2000, "Unexpected number of idle bytes");
+        NS_TEST_ASSERT_MSG_EQ_TOL(qdisc->GetUtilization(), 0.5, 1e-9, "Unexpected utilization");
+    }
+
+    // percentiles are accurate within the width of a log-scale bucket
+    CanlendarQueueDisc::LatencyHistogram histogram;
+    for (uint32_t i = 1; i <= 1000; i++)
+    {
+        histogram.Record(MicroSeconds(i));
+    }
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetCount(), 1000, "Unexpected number of samples");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMax(), MicroSeconds(1000), "Unexpected largest sample");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetPercentile(0.5).GetMicroSeconds(),
+                              500,
+                              500 / 16,
+                              "Unexpected median");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetPercentile(0.99).GetMicroSeconds(),
+                              990,
+                              990 / 16,
+                              "Unexpected 99th percentile");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(1), MicroSeconds(1000), "Unexpected maximum");
+    histogram.Reset();
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(0.5), Time(0), "The histogram should be empty");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Compare the canlendar queue disc against the class-based implementation
+ */
+class CanlendarQueueDiscEquivalenceTestCase : public TestCase
+{
+  public:
+    CanlendarQueueDiscEquivalenceTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Enqueue a copy of the same packets in both queue discs and dequeue from
+     * both, checking that the same decisions are made.
+     * \param n the number of packets to enqueue
+     * \param m the number of packets to dequeue
+     */
+    void Step(uint32_t n, uint32_t m);
+    /// \return a pseudo-random number
+    uint32_t Next();
+
+    Ptr<CanlendarQueueDisc> m_calendar;      //!< the native calendar
+    Ptr<ClassBasedCanlendarQueueDisc> m_ref; //!< the reference implementation
+    uint32_t m_seed;                         //!< state of the pseudo-random generator
+    uint32_t m_nDequeued;                    //!< number of packets dequeued by both
+};
+
+CanlendarQueueDiscEquivalenceTestCase::CanlendarQueueDiscEquivalenceTestCase()
+    : TestCase("Check the canlendar queue disc against the class-based implementation"),
+      m_seed(12345),
+      m_nDequeued(0)
+{
+}
+
+uint32_t
+CanlendarQueueDiscEquivalenceTestCase::Next()
+{
+    m_seed = m_seed * 1103515245 + 12345;
+    return (m_seed >> 16) & 0x7fff;
+}
+
+void
+CanlendarQueueDiscEquivalenceTestCase::Step(uint32_t n, uint32_t m)
+{
+    Address dest;
+    const double deadlines[] = {0, 0.01, 0.05, 0.1, 0.35};
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t kind = Next() % 3;
+        uint32_t size = 100 + Next() % 2900;
+        Ptr<Packet> p;
+        if (kind == 2)
+        {
+            p = Create<Packet>(size);
+        }
+        else
+        {
+            p = CreateTaggedPacket(size,
+                                   kind == 0 ? FlowTypeTag::PREFILL : FlowTypeTag::DECODE,
+                                   deadlines[Next() % 5]);
+            if (Next() % 4 == 0)
+            {
+                // delay accumulated at a previous hop
+                DelayTag delaytag;
+                delaytag.SetTimestamp(MilliSeconds(20));
+                p->AddPacketTag(delaytag);
+            }
+        }
+        bool ret1 = m_calendar->Enqueue(Create<CanlendarQueueDiscTestItem>(p, dest));
+        bool ret2 = m_ref->Enqueue(Create<CanlendarQueueDiscTestItem>(p->Copy(), dest));
+        NS_TEST_ASSERT_MSG_EQ(ret1, ret2, "Enqueue outcome differs at " << Simulator::Now());
+    }
+
+    for (uint32_t i = 0; i < m; i++)
+    {
+        Ptr<QueueDiscItem> item1 = m_calendar->Dequeue();
+        Ptr<QueueDiscItem> item2 = m_ref->Dequeue();
+        NS_TEST_ASSERT_MSG_EQ((item1 == nullptr), (item2 == nullptr), "Only one queue is empty");
+        if (!item1 || !item2)
+        {
+            break;
+        }
+        NS_TEST_ASSERT_MSG_EQ(item1->GetPacket()->GetUid(),
+                              item2->GetPacket()->GetUid(),
+                              "Dequeued packets differ at " << Simulator::Now());
+        m_nDequeued++;
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(m_calendar->GetNPackets(), m_ref->GetNPackets(), "Packets differ");
+    NS_TEST_ASSERT_MSG_EQ(m_calendar->GetNBytes(), m_ref->GetNBytes(), "Bytes differ");
+}
+
+void
+CanlendarQueueDiscEquivalenceTestCase::DoRun()
+{
+    // the drain rate lets the current slot send 20000 bytes per rotation
+    m_calendar = CreateObjectWithAttributes<CanlendarQueueDisc>("NumSlots",
+                                                                UintegerValue(100),
+                                                                "SlotCapacityBytes",
+                                                                UintegerValue(20000),
+                                                                "DrainRate",
+                                                                StringValue("16Mbps"),
+                                                                "RotationInterval",
+                                                                StringValue("10ms"));
+    m_ref = CreateObjectWithAttributes<ClassBasedCanlendarQueueDisc>("NumSlots",
+                                                                     UintegerValue(100),
+                                                                     "SlotCapacityBytes",
+                                                                     UintegerValue(20000),
+                                                                     "DrainRate",
+                                                                     StringValue("16Mbps"),
+                                                                     "RotationInterval",
+                                                                     StringValue("10ms"));
+    m_calendar->Initialize();
+    m_ref->Initialize();
+
+    // alternate bursts, in which slots overflow, with phases where the
+    // dequeue rate exceeds the arrival rate, and leave the queue discs idle
+    // for more than a full turn of the calendar; operations are scheduled
+    // away from the rotation instants
+    for (uint32_t k = 0; k < 3000; k++)
+    {
+        if (k >= 1500 && k < 2700)
+        {
+            continue;
+        }
+        uint32_t n = (k % 400 < 100) ? 20 : 2;
+        uint32_t m = (k % 400 < 100) ? 5 : 12;
+        Simulator::Schedule(MicroSeconds(1000 * k + 250),
+                            &CanlendarQueueDiscEquivalenceTestCase::Step,
+                            this,
+                            n,
+                            m);
+    }
+    Simulator::Stop(Seconds(3.1));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_GT(m_nDequeued, 5000, "Too few packets went through the queue discs");
+    QueueDisc::Stats st1 = m_calendar->GetStats();
+    QueueDisc::Stats st2 = m_ref->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(st1.nTotalEnqueuedPackets,
+                          st2.nTotalEnqueuedPackets,
+                          "Enqueued packets differ");
+    NS_TEST_ASSERT_MSG_EQ(st1.nTotalDroppedPackets, st2.nTotalDroppedPackets, "Drops differ");
+
+    m_calendar = nullptr;
+    m_ref = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check the canlendar queue disc as a child of the multi-queue queue disc
+ */
+class CanlendarQueueDiscMqTestCase : public TestCase
+{
+  public:
+    CanlendarQueueDiscMqTestCase();
+    void DoRun() override;
+};
+
+CanlendarQueueDiscMqTestCase::CanlendarQueueDiscMqTestCase()
+    : TestCase("Check one canlendar queue disc per transmission queue under an mq queue disc")
+{
+}
+
+void
+CanlendarQueueDiscMqTestCase::DoRun()
+{
+    const std::size_t nTxQueues = 2;
+
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetAttribute("DataRate", StringValue("8Mbps"));
+    node->AddDevice(device);
+    Ptr<NetDeviceQueueInterface> ndqi =
+        CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues",
+                                                            UintegerValue(nTxQueues));
+    device->AggregateObject(ndqi);
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    node->AggregateObject(tc);
+
+    TrafficControlHelper tch;
+    uint16_t handle = tch.SetRootQueueDisc("ns3::MqQueueDisc");
+    TrafficControlHelper::ClassIdList cls =
+        tch.AddQueueDiscClasses(handle, nTxQueues, "ns3::QueueDiscClass");
+    tch.AddChildQueueDiscs(handle,
+                           cls,
+                           "ns3::CanlendarQueueDisc",
+                           "RotationInterval",
+                           StringValue("10ms"));
+    QueueDiscContainer qdiscs = tch.Install(device);
+    node->Initialize();
+
+    Ptr<QueueDisc> root = qdiscs.Get(0);
+    std::vector<Ptr<CanlendarQueueDisc>> shards;
+    std::vector<uint32_t> nSent(nTxQueues, 0);
+    for (std::size_t i = 0; i < nTxQueues; i++)
+    {
+        Ptr<QueueDisc> child = root->GetQueueDiscClass(i)->GetQueueDisc();
+        shards.push_back(child->GetObject<CanlendarQueueDisc>());
+        NS_TEST_ASSERT_MSG_EQ(shards[i]->GetDrainRate(),
+                              DataRate("4Mbps"),
+                              "Each shard should drain at an equal share of the device rate");
+        NS_TEST_ASSERT_MSG_EQ(shards[i]->GetSlotCapacity(), 5000, "Unexpected slot capacity");
+        shards[i]->SetSendCallback([&nSent, i](Ptr<QueueDiscItem>) { nSent[i]++; });
+    }
+
+    // while the first transmission queue is stopped, the second shard keeps
+    // sending its packets
+    ndqi->GetTxQueue(0)->Stop();
+    Address dest;
+    for (std::size_t i = 0; i < nTxQueues; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            Ptr<QueueDiscItem> item =
+                Create<CanlendarQueueDiscTestItem>(Create<Packet>(1000), dest);
+            item->SetTxQueueIndex(i);
+            shards[i]->Enqueue(item);
+        }
+        shards[i]->Run();
+    }
+    NS_TEST_ASSERT_MSG_EQ(nSent[0], 0, "The stopped shard should not send packets");
+    // the head packet of the stopped shard is dequeued and held for requeue
+    NS_TEST_ASSERT_MSG_EQ(shards[0]->GetNPackets(), 2, "The stopped shard should keep its packets");
+    NS_TEST_ASSERT_MSG_EQ(shards[0]->GetStats().nTotalRequeuedPackets,
+                          1,
+                          "The head packet of the stopped shard should be requeued");
+    NS_TEST_ASSERT_MSG_EQ(nSent[1], 3, "The running shard should send its packets");
+    NS_TEST_ASSERT_MSG_EQ(shards[1]->GetNPackets(), 0, "The running shard should be empty");
+    NS_TEST_ASSERT_MSG_EQ(root->GetNPackets(), 2, "The root should account for all shards");
+
+    // waking the stopped transmission queue runs its shard only
+    ndqi->GetTxQueue(0)->Wake();
+    NS_TEST_ASSERT_MSG_EQ(nSent[0], 3, "The woken shard should send its packets");
+    NS_TEST_ASSERT_MSG_EQ(root->GetNPackets(), 0, "The root should be empty");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Canlendar Queue Disc Test Suite
+ */
+static class CanlendarQueueDiscTestSuite : public TestSuite
+{
+  public:
+    CanlendarQueueDiscTestSuite()
+        : TestSuite("canlendar-queue-disc", Type::UNIT)
+    {
+        AddTestCase(new CanlendarQueueDiscTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new CanlendarQueueDiscEquivalenceTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new CanlendarQueueDiscMqTestCase(), TestCase::Duration::QUICK);
+    }
+} g_canlendarQueueTestSuite; ///< the test suite
@@ -9,18 +9,27 @@
 // This program can be used to benchmark packet serialization/deserialization
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
+// Compare the packet tags stored in hot tag slots and in the tag list with
+//   ./ns3 run 'bench-packets --n=10000 --hot-tags=false'
+// and the packets allocated from the PoolAllocator and from the heap with
+//   ./ns3 run 'bench-packets --n=10000 --pool=false'
 
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
+#include "ns3/pool-allocator.h"
+#include "ns3/queue-item.h"
 #include "ns3/system-wall-clock-ms.h"
 
 #include <algorithm>
+#include <deque>
 #include <iostream>
 #include <limits>
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
+#include <tuple>
 
 using namespace ns3;
 
@@ -339,6 +348,74 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchQueueItems(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    // A standing queue of 1000 packets, each freed when dequeued
+    std::deque<Ptr<QueueItem>> queue;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(2000);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        queue.push_back(Create<QueueItem>(p));
+        if (queue.size() > 1000)
+        {
+            queue.pop_front();
+        }
+    }
+}
+
+/// The packet tags of the packet tag benchmarks: a flow type, a deadline,
+/// a delay and a timestamp
+using HotTags = std::tuple<BenchTag<1>, BenchTag<6>, BenchTag<7>, BenchTag<8>>;
+
+static void
+benchAddPacketTags(uint32_t n)
+{
+    HotTags tags;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(2000);
+        std::apply([&p](auto&... tag) { (p->AddPacketTag(tag), ...); }, tags);
+    }
+}
+
+static void
+benchPeekPacketTags(uint32_t n)
+{
+    HotTags tags;
+    Ptr<Packet> p = Create<Packet>(2000);
+    std::apply([&p](auto&... tag) { (p->AddPacketTag(tag), ...); }, tags);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        // Once per hop or queue disc
+        for (uint32_t hop = 0; hop < 4; hop++)
+        {
+            std::apply([&p](auto&... tag) { (p->PeekPacketTag(tag), ...); }, tags);
+        }
+    }
+}
+
+static void
+benchForwardPacketTags(uint32_t n)
+{
+    HotTags tags;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(2000);
+        std::apply([&p](auto&... tag) { (p->AddPacketTag(tag), ...); }, tags);
+        for (uint32_t hop = 0; hop < 4; hop++)
+        {
+            p = p->Copy();
+            std::apply([&p](auto&... tag) { (p->PeekPacketTag(tag), ...); }, tags);
+        }
+        std::apply([&p](auto&... tag) { (p->RemovePacketTag(tag), ...); }, tags);
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -371,6 +448,8 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool hotTags = true;
+    bool pool = true;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -379,7 +458,10 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("hot-tags", "store the packet tags in hot tag slots", hotTags);
+    cmd.AddValue("pool", "allocate the packets from the PoolAllocator", pool);
     cmd.Parse(argc, argv);
+    PoolAllocator::SetEnabled(pool);
 
     if (n == 0)
     {
@@ -396,6 +478,23 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchQueueItems, n, minIterations, "Enqueue and dequeue queue items");
 
+    if (hotTags)
+    {
+        std::apply([](const auto&... tag) { (PacketTagList::RegisterHotTag(tag.GetTypeId()), ...); },
+                   HotTags());
+    }
+    std::cout << "Packet tags are stored " << (hotTags ? "in hot tag slots" : "in the tag list")
+              << std::endl;
+    runBench(&benchAddPacketTags, n, minIterations, "Add 4 packet tags");
+    runBench(&benchPeekPacketTags, n, minIterations, "Peek 4 packet tags at 4 hops");
+    runBench(&benchForwardPacketTags, n, minIterations, "Add, copy and peek at 4 hops, remove");
+
+    if (pool)
+    {
+        std::cout << "PoolAllocator statistics:" << std::endl;
+        PoolAllocator::PrintStats(std::cout);
+    }
     return 0;
 }
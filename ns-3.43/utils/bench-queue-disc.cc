@@ -0,0 +1,413 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the enqueue and dequeue operations of queue discs,
+// which are driven directly (with no network stack) by a synthetic stream of
+// prefill and decode packets.
+// Sample usage:  ./ns3 run 'bench-queue-disc --all --occupancy=1000'
+
+#include "ns3/canlendar-queue-disc.h"
+#include "ns3/core-module.h"
+#include "ns3/data-rate.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/queue-disc.h"
+#include "ns3/tags.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace ns3;
+
+/** Number of heap allocations performed so far. */
+static uint64_t g_nAllocs = 0;
+
+/**
+ * Count the heap allocations, to report the allocations per operation.
+ * \param [in] size The number of bytes to allocate.
+ * \returns The allocated memory.
+ */
+void*
+operator new(std::size_t size)
+{
+    g_nAllocs++;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC cannot tell that the memory released here was allocated by malloc in
+// the replaced operator new
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory to release.
+ */
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory to release.
+ */
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/** Queue disc item carrying a synthetic flow identifier. */
+class BenchQueueDiscItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     * \param [in] p The packet.
+     * \param [in] flow The flow identifier, returned as the flow hash.
+     */
+    BenchQueueDiscItem(Ptr<Packet> p, uint32_t flow)
+        : QueueDiscItem(p, Address(), 0),
+          m_flow(flow)
+    {
+    }
+
+    void AddHeader() override
+    {
+    }
+
+    bool Mark() override
+    {
+        return false;
+    }
+
+    uint32_t Hash(uint32_t perturbation = 0) const override
+    {
+        return m_flow ^ perturbation;
+    }
+
+  private:
+    uint32_t m_flow; //!< The flow identifier
+};
+
+/** The workload offered to the queue disc. */
+struct Workload
+{
+    uint32_t occupancy; /**< Number of packets kept in the queue disc. */
+    uint64_t ops;       /**< Number of enqueue and dequeue operations to measure. */
+    uint32_t size;      /**< Packet size (bytes). */
+    uint32_t flows;     /**< Number of flows. */
+    double decode;      /**< Fraction of decode packets. */
+    double minDeadline; /**< Minimum deadline (s). */
+    double maxDeadline; /**< Maximum deadline (s). */
+    DataRate rate;      /**< Arrival rate, which equals the departure rate. */
+};
+
+/**
+ *  Benchmark instance which can do a single run.
+ *
+ *  The queue disc is first filled with the given number of packets. Then, a
+ *  packet is enqueued and a packet is dequeued every packet transmission time
+ *  at the given rate, so that the occupancy stays constant. Only the time
+ *  spent in QueueDisc::Enqueue and QueueDisc::Dequeue is measured, and it
+ *  includes the overhead of reading the clock.
+ */
+class Bench
+{
+  public:
+    /**
+     * Constructor
+     * \param [in] factory Factory pre-configured to create the queue disc.
+     * \param [in] workload The workload.
+     */
+    Bench(const ObjectFactory& factory, const Workload& workload);
+
+    /** The output. */
+    struct Result
+    {
+        double nsPerOp;     /**< Average time (ns) per operation. */
+        double allocsPerOp; /**< Average heap allocations per operation. */
+        Time p50;           /**< Median operation latency. */
+        Time p99;           /**< 99th percentile of the operation latency. */
+        uint64_t drops;     /**< Number of dropped packets. */
+    };
+
+    /**
+     *  Run the benchmark as configured.
+     *
+     * \returns The Result.
+     */
+    Result Run();
+
+  private:
+    /** \returns A new packet, tagged according to the workload. */
+    Ptr<QueueDiscItem> CreateItem();
+
+    /** Enqueue and dequeue one packet, then schedule the next step. */
+    void Step();
+
+    /**
+     * Account for an operation.
+     * \param [in] start The time the operation started.
+     * \param [in] allocs The number of allocations when the operation started.
+     */
+    void Measure(std::chrono::steady_clock::time_point start, uint64_t allocs);
+
+    ObjectFactory m_factory;                        /**< Factory of the queue disc. */
+    Workload m_workload;                            /**< The workload. */
+    Ptr<QueueDisc> m_qdisc;                         /**< The queue disc under test. */
+    Ptr<UniformRandomVariable> m_rand;              /**< Stream for the packet tags. */
+    Time m_gap;                                     /**< Time between two steps. */
+    uint64_t m_count;                               /**< Number of operations measured so far. */
+    uint64_t m_allocs;                              /**< Allocations in the measured operations. */
+    std::chrono::nanoseconds m_elapsed;             /**< Time spent in the measured operations. */
+    CanlendarQueueDisc::LatencyHistogram m_latency; /**< Operation latencies. */
+};
+
+Bench::Bench(const ObjectFactory& factory, const Workload& workload)
+    : m_factory(factory),
+      m_workload(workload),
+      m_count(0),
+      m_allocs(0),
+      m_elapsed(0)
+{
+    m_rand = CreateObject<UniformRandomVariable>();
+    m_gap = m_workload.rate.CalculateBytesTxTime(m_workload.size);
+}
+
+Ptr<QueueDiscItem>
+Bench::CreateItem()
+{
+    Ptr<Packet> p = Create<Packet>(m_workload.size);
+    bool decode = m_rand->GetValue() < m_workload.decode;
+    FlowTypeTag flowType;
+    flowType.SetType(decode ? FlowTypeTag::DECODE : FlowTypeTag::PREFILL);
+    p->AddPacketTag(flowType);
+    DeadlineTag deadline;
+    deadline.SetDeadline(m_rand->GetValue(m_workload.minDeadline, m_workload.maxDeadline));
+    p->AddPacketTag(deadline);
+    auto flow = static_cast<uint32_t>(m_rand->GetInteger(0, m_workload.flows - 1));
+    return Create<BenchQueueDiscItem>(p, flow);
+}
+
+void
+Bench::Measure(std::chrono::steady_clock::time_point start, uint64_t allocs)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_allocs += g_nAllocs - allocs;
+    m_elapsed += elapsed;
+    m_latency.Record(NanoSeconds(std::chrono::nanoseconds(elapsed).count()));
+    m_count++;
+}
+
+void
+Bench::Step()
+{
+    Ptr<QueueDiscItem> item = CreateItem();
+
+    uint64_t allocs = g_nAllocs;
+    auto start = std::chrono::steady_clock::now();
+    m_qdisc->Enqueue(item);
+    Measure(start, allocs);
+    item = nullptr;
+
+    allocs = g_nAllocs;
+    start = std::chrono::steady_clock::now();
+    item = m_qdisc->Dequeue();
+    Measure(start, allocs);
+
+    if (m_count < m_workload.ops)
+    {
+        Simulator::Schedule(m_gap, &Bench::Step, this);
+    }
+}
+
+Bench::Result
+Bench::Run()
+{
+    m_count = 0;
+    m_allocs = 0;
+    m_elapsed = std::chrono::nanoseconds(0);
+    m_latency.Reset();
+
+    m_qdisc = m_factory.Create<QueueDisc>();
+    if (auto fqCoDel = DynamicCast<FqCoDelQueueDisc>(m_qdisc))
+    {
+        // there is no device to take the quantum from
+        fqCoDel->SetQuantum(1500);
+    }
+    m_qdisc->Initialize();
+    for (uint32_t i = 0; i < m_workload.occupancy; i++)
+    {
+        m_qdisc->Enqueue(CreateItem());
+    }
+
+    Simulator::Schedule(m_gap, &Bench::Step, this);
+    Simulator::Run();
+
+    Result result{static_cast<double>(m_elapsed.count()) / m_count,
+                  static_cast<double>(m_allocs) / m_count,
+                  m_latency.GetPercentile(0.5),
+                  m_latency.GetPercentile(0.99),
+                  m_qdisc->GetStats().nTotalDroppedPackets};
+
+    m_qdisc->Dispose();
+    m_qdisc = nullptr;
+    Simulator::Destroy();
+
+    return result;
+}
+
+/**
+ * Perform the runs for a single queue disc type and log the results.
+ *
+ * \param [in] factory Factory pre-configured to create the queue disc.
+ * \param [in] workload The workload.
+ * \param [in] runs The number of replications.
+ */
+void
+BenchQueueDisc(const ObjectFactory& factory, const Workload& workload, uint64_t runs)
+{
+    LOG("");
+    LOG(factory.GetTypeId().GetName());
+    LOG(std::left << std::setw(g_fwidth) << "Run #" << std::setw(g_fwidth) << "ns/op"
+                  << std::setw(g_fwidth) << "allocs/op" << std::setw(g_fwidth) << "p50 (ns)"
+                  << std::setw(g_fwidth) << "p99 (ns)" << "drops");
+
+    Bench bench(factory, workload);
+    for (uint64_t i = 0; i < runs; i++)
+    {
+        auto r = bench.Run();
+        LOG(std::left << std::setw(g_fwidth) << i << std::setw(g_fwidth) << r.nsPerOp
+                      << std::setw(g_fwidth) << r.allocsPerOp << std::setw(g_fwidth)
+                      << r.p50.GetNanoSeconds() << std::setw(g_fwidth) << r.p99.GetNanoSeconds()
+                      << r.drops);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    bool all = false;
+    bool calendar = false;
+    bool fifo = false;
+    bool prio = false;
+    bool fqCoDel = false;
+
+    uint32_t slots = 200;
+    std::string interval = "1ms";
+    bool edf = false;
+    uint64_t runs = 1;
+    std::string rate = "10Gbps";
+    Workload workload{1000, 1000000, 1000, 64, 0.5, 0.01, 0.1, DataRate()};
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the enqueue and dequeue operations of queue discs.\n"
+              "\n"
+              "The queue disc is filled with --occupancy packets, then a packet is\n"
+              "enqueued and one is dequeued every packet transmission time at --rate.\n"
+              "Packets carry a FlowTypeTag (decode with probability --decode, prefill\n"
+              "otherwise) and a DeadlineTag uniformly distributed between\n"
+              "--minDeadline and --maxDeadline.\n"
+              "\n"
+              "If no queue disc is specified the CanlendarQueueDisc will be run.");
+    cmd.AddValue("all", "use all queue discs", all);
+    cmd.AddValue("calendar", "use CanlendarQueueDisc (default)", calendar);
+    cmd.AddValue("fifo", "use FifoQueueDisc", fifo);
+    cmd.AddValue("prio", "use PrioQueueDisc", prio);
+    cmd.AddValue("fqcodel", "use FqCoDelQueueDisc", fqCoDel);
+    cmd.AddValue("slots", "number of slots of the CanlendarQueueDisc", slots);
+    cmd.AddValue("interval", "rotation interval of the CanlendarQueueDisc", interval);
+    cmd.AddValue("edf", "serve the slots of the CanlendarQueueDisc in EDF order", edf);
+    cmd.AddValue("occupancy", "number of packets kept in the queue disc", workload.occupancy);
+    cmd.AddValue("ops", "number of enqueue and dequeue operations per run", workload.ops);
+    cmd.AddValue("size", "packet size (bytes)", workload.size);
+    cmd.AddValue("flows", "number of flows", workload.flows);
+    cmd.AddValue("decode", "fraction of decode packets", workload.decode);
+    cmd.AddValue("minDeadline", "minimum deadline (s)", workload.minDeadline);
+    cmd.AddValue("maxDeadline", "maximum deadline (s)", workload.maxDeadline);
+    cmd.AddValue("rate", "packet arrival and departure rate", rate);
+    cmd.AddValue("runs", "number of runs", runs);
+    cmd.Parse(argc, argv);
+
+    workload.rate = DataRate(rate);
+    // leave room for the occupancy in the queue discs with a packet limit
+    std::string maxPackets = std::to_string(2 * workload.occupancy + 1000) + "p";
+
+    LOG("");
+    LOG(cmd.GetName() << ": Benchmark the queue discs");
+    LOG("  Occupancy (packets):          " << workload.occupancy);
+    LOG("  Operations per run:           " << workload.ops);
+    LOG("  Decode fraction:              " << workload.decode);
+    LOG("  Deadlines (s):                " << workload.minDeadline << " - "
+                                            << workload.maxDeadline);
+    LOG("  Rate:                         " << workload.rate);
+    LOG("  Number of runs per queue disc: " << runs);
+
+    if (all)
+    {
+        calendar = fifo = prio = fqCoDel = true;
+    }
+    // Set the default case if nothing else is set
+    if (!(calendar || fifo || prio || fqCoDel))
+    {
+        calendar = true;
+    }
+
+    ObjectFactory factory;
+    if (calendar)
+    {
+        factory.SetTypeId("ns3::CanlendarQueueDisc");
+        factory.Set("NumSlots",
+                    UintegerValue(slots),
+                    "RotationInterval",
+                    StringValue(interval),
+                    "DrainRate",
+                    DataRateValue(workload.rate),
+                    "SlotOrdering",
+                    StringValue(edf ? "Edf" : "Fifo"));
+        BenchQueueDisc(factory, workload, runs);
+    }
+    if (fifo)
+    {
+        factory = ObjectFactory("ns3::FifoQueueDisc");
+        factory.Set("MaxSize", StringValue(maxPackets));
+        BenchQueueDisc(factory, workload, runs);
+    }
+    if (prio)
+    {
+        factory = ObjectFactory("ns3::PrioQueueDisc");
+        BenchQueueDisc(factory, workload, runs);
+    }
+    if (fqCoDel)
+    {
+        factory = ObjectFactory("ns3::FqCoDelQueueDisc");
+        factory.Set("MaxSize", StringValue(maxPackets));
+        BenchQueueDisc(factory, workload, runs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the enqueue and dequeue operations of a
+// DropTailQueue<Packet> storing its packets in a RingBuffer (the default
+// container) and in a std::list, at several queue occupancies.
+// Sample usage:  ./ns3 run 'bench-queue --occupancy=1000,10000,100000,1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include "ns3/ring-buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/** Output field width for numeric data. */
+const int g_fwidth = 14;
+
+/** The output of a run. */
+struct Result
+{
+    double fillNsPerOp;  /**< Average time (ns) per enqueue while filling the queue. */
+    double nsPerOp;      /**< Average time (ns) per operation at constant occupancy. */
+    double drainNsPerOp; /**< Average time (ns) per dequeue while draining the queue. */
+};
+
+/**
+ * Fill a queue with the given number of packets, then enqueue and dequeue
+ * a packet the given number of times, and finally drain the queue.
+ *
+ * The same packet is enqueued over and over, so that only the queue and its
+ * container are measured.
+ *
+ * \tparam Container \explicit The container of the queue.
+ * \param [in] occupancy The number of packets kept in the queue.
+ * \param [in] ops The number of enqueue and dequeue operations.
+ * \returns The Result.
+ */
+template <typename Container>
+Result
+Run(uint32_t occupancy, uint64_t ops)
+{
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::duration elapsed, uint64_t n) {
+        return n == 0 ? 0.0 : std::chrono::duration<double, std::nano>(elapsed).count() / n;
+    };
+
+    auto queue = CreateObject<DropTailQueue<Packet, Container>>();
+    queue->SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, occupancy + 1));
+    Ptr<Packet> packet = Create<Packet>(1000);
+    Result result;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < occupancy; ++i)
+    {
+        queue->Enqueue(packet);
+    }
+    result.fillNsPerOp = nsPerOp(Clock::now() - start, occupancy);
+
+    start = Clock::now();
+    for (uint64_t i = 0; i < ops; ++i)
+    {
+        queue->Enqueue(packet);
+        queue->Dequeue();
+    }
+    result.nsPerOp = nsPerOp(Clock::now() - start, 2 * ops);
+
+    start = Clock::now();
+    while (queue->Dequeue())
+    {
+    }
+    result.drainNsPerOp = nsPerOp(Clock::now() - start, occupancy);
+
+    queue->Dispose();
+    return result;
+}
+
+/**
+ * Run the benchmark of both containers at the given occupancy.
+ *
+ * \param [in] occupancy The number of packets kept in the queue.
+ * \param [in] ops The number of enqueue and dequeue operations per run.
+ * \param [in] runs The number of runs, of which the fastest is reported.
+ */
+void
+BenchOccupancy(uint32_t occupancy, uint64_t ops, uint32_t runs)
+{
+    auto best = [runs](Result (*run)(uint32_t, uint64_t), uint32_t occupancy, uint64_t ops) {
+        Result best = run(occupancy, ops);
+        for (uint32_t i = 1; i < runs; ++i)
+        {
+            Result result = run(occupancy, ops);
+            best.fillNsPerOp = std::min(best.fillNsPerOp, result.fillNsPerOp);
+            best.nsPerOp = std::min(best.nsPerOp, result.nsPerOp);
+            best.drainNsPerOp = std::min(best.drainNsPerOp, result.drainNsPerOp);
+        }
+        return best;
+    };
+
+    Result ring = best(&Run<RingBuffer<Ptr<Packet>>>, occupancy, ops);
+    Result list = best(&Run<PacketList>, occupancy, ops);
+
+    std::cout << std::left << std::setw(g_fwidth) << occupancy << std::right << std::fixed
+              << std::setprecision(1) << std::setw(g_fwidth) << ring.fillNsPerOp
+              << std::setw(g_fwidth) << list.fillNsPerOp << std::setw(g_fwidth) << ring.nsPerOp
+              << std::setw(g_fwidth) << list.nsPerOp << std::setw(g_fwidth) << ring.drainNsPerOp
+              << std::setw(g_fwidth) << list.drainNsPerOp << std::setw(g_fwidth)
+              << std::setprecision(2) << list.nsPerOp / ring.nsPerOp << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string occupancies = "1000,10000,100000,1000000";
+    uint64_t ops = 1000000;
+    uint32_t runs = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the enqueue and dequeue operations of a DropTailQueue\n"
+              "storing its packets in a RingBuffer and in a std::list.\n"
+              "\n"
+              "For each occupancy, the queue is filled, then a packet is enqueued and\n"
+              "one is dequeued --ops times, and the queue is drained. The times per\n"
+              "operation (ns) of each phase are reported for both containers.");
+    cmd.AddValue("occupancy", "comma separated numbers of packets kept in the queue", occupancies);
+    cmd.AddValue("ops", "number of enqueue and dequeue operations per run", ops);
+    cmd.AddValue("runs", "number of runs, of which the fastest is reported", runs);
+    cmd.Parse(argc, argv);
+
+    std::vector<uint32_t> values;
+    std::istringstream iss(occupancies);
+    for (std::string value; std::getline(iss, value, ',');)
+    {
+        values.push_back(std::stoul(value));
+    }
+
+    LOG("");
+    LOG(cmd.GetName() << ": Benchmark the containers of DropTailQueue (ns per operation)");
+    LOG("  Operations per run:           " << ops);
+    LOG("  Number of runs:               " << runs);
+    LOG("");
+    std::cout << std::left << std::setw(g_fwidth) << "occupancy" << std::right
+              << std::setw(g_fwidth) << "fill-ring" << std::setw(g_fwidth) << "fill-list"
+              << std::setw(g_fwidth) << "steady-ring" << std::setw(g_fwidth) << "steady-list"
+              << std::setw(g_fwidth) << "drain-ring" << std::setw(g_fwidth) << "drain-list"
+              << std::setw(g_fwidth) << "list/ring" << std::endl;
+    for (uint32_t occupancy : values)
+    {
+        BenchOccupancy(occupancy, ops, runs);
+    }
+
+    return 0;
+}
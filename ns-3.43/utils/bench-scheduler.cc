@@ -8,10 +8,13 @@
 
 #include "ns3/core-module.h"
 
+#include <algorithm>
 #include <cmath> // sqrt
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string.h>
 #include <vector>
 
@@ -36,13 +39,25 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** An operation of a scheduler trace. */
+struct TraceOp
+{
+    char op;      /**< The operation: 'i' Insert, 'r' RemoveNext, 'c' Remove. */
+    uint64_t ts;  /**< The event timestamp. */
+    uint32_t uid; /**< The event uid. */
+};
+
+/** A scheduler trace, as written by the RecordingScheduler. */
+using Trace = std::vector<TraceOp>;
+
 /**
  *  Benchmark instance which can do a single run.
  *
  *  The run is controlled by the event population size and
  *  total number of events, which are set at construction.
  *
- *  The event distribution in time is set by SetRandomStream()
+ *  The event distribution in time is set by SetRandomStream(),
+ *  unless a recorded trace is replayed, as set by SetTrace().
  */
 class Bench
 {
@@ -53,12 +68,23 @@ class Bench
      * \param [in] total The total number of events to execute.
      */
     Bench(const uint64_t population, const uint64_t total)
-        : m_population(population),
+        : m_trace(nullptr),
+          m_population(population),
           m_total(total),
           m_count(0)
     {
     }
 
+    /**
+     * Set the trace to replay, instead of running the simulator.
+     *
+     * \param [in] trace The trace, or \c nullptr to run the simulator.
+     */
+    void SetTrace(const Trace* trace)
+    {
+        m_trace = trace;
+    }
+
     /**
      * Set the event delay interval random stream.
      *
@@ -101,11 +127,36 @@ class Bench
     /**
      *  Run the benchmark as configured.
      *
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
      * \returns The Result.
      */
-    Result Run();
+    Result Run(ObjectFactory& factory);
 
   private:
+    /**
+     *  Replay the trace directly on a scheduler.
+     *
+     *  The initialization is the operations up to the first RemoveNext,
+     *  the simulation the remaining operations.
+     *
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
+     * \returns The Result.
+     */
+    Result Replay(ObjectFactory& factory);
+
+    /**
+     *  Replay a range of the trace.
+     *
+     * \param [in] scheduler The scheduler.
+     * \param [in] impl The implementation of all the events.
+     * \param [in] begin The first operation.
+     * \param [in] end Past the last operation.
+     */
+    static void Replay(Ptr<Scheduler> scheduler,
+                       EventImpl* impl,
+                       Trace::const_iterator begin,
+                       Trace::const_iterator end);
+
     /**
      *  Event function. This checks for completion (total number of events
      *  executed) and schedules a new event if not complete.
@@ -113,6 +164,7 @@ class Bench
     void Cb();
 
     Ptr<RandomVariableStream> m_rand; /**< Stream for event delays. */
+    const Trace* m_trace;             /**< Trace to replay, if any. */
     uint64_t m_population;            /**< Event population size. */
     uint64_t m_total;                 /**< Total number of events to execute. */
     uint64_t m_count;                 /**< Count of events executed so far. */
@@ -120,12 +172,20 @@ class Bench
 }; // class Bench
 
 Bench::Result
-Bench::Run()
+Bench::Run(ObjectFactory& factory)
 {
+    if (m_trace)
+    {
+        return Replay(factory);
+    }
+
     SystemWallClockMs timer;
     double init;
     double simu;
 
+    // Each run destroys the simulator, and with it the scheduler
+    Simulator::SetScheduler(factory);
+
     DEB("initializing");
     m_count = 0;
 
@@ -149,6 +209,77 @@ Bench::Run()
     return Result{init, simu, m_population, m_count};
 }
 
+Bench::Result
+Bench::Replay(ObjectFactory& factory)
+{
+    SystemWallClockMs timer;
+    double init;
+    double simu;
+
+    // The schedulers only compare the event implementations, so all the
+    // events can share one
+    Ptr<EventImpl> impl(MakeEvent([]() {}), false);
+    Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+    auto first = std::find_if(m_trace->begin(), m_trace->end(), [](const TraceOp& op) {
+        return op.op == 'r';
+    });
+
+    DEB("initializing");
+    timer.Start();
+    Replay(scheduler, PeekPointer(impl), m_trace->begin(), first);
+    init = timer.End() / 1000.0;
+    DEB("initialization took " << init << "s");
+
+    DEB("replaying");
+    timer.Start();
+    Replay(scheduler, PeekPointer(impl), first, m_trace->end());
+    simu = timer.End() / 1000.0;
+    DEB("replay took " << simu << "s");
+
+    // Release builds have no logging to tell what the AdaptiveScheduler did
+    if (auto adaptive = DynamicCast<AdaptiveScheduler>(scheduler))
+    {
+        LOGME(adaptive->GetNMigrations() << " migrations, ending with "
+                                         << adaptive->GetBackend().GetName());
+    }
+
+    while (!scheduler->IsEmpty())
+    {
+        scheduler->RemoveNext();
+    }
+    scheduler->Dispose();
+
+    uint64_t pop = first - m_trace->begin();
+    return Result{init, simu, pop, m_trace->size() - pop};
+}
+
+/* static */
+void
+Bench::Replay(Ptr<Scheduler> scheduler,
+              EventImpl* impl,
+              Trace::const_iterator begin,
+              Trace::const_iterator end)
+{
+    for (auto it = begin; it != end; ++it)
+    {
+        Scheduler::Event ev{impl, {it->ts, it->uid, 0}};
+        switch (it->op)
+        {
+        case 'i':
+            scheduler->Insert(ev);
+            break;
+        case 'r':
+            ev = scheduler->RemoveNext();
+            NS_ABORT_MSG_IF(ev.key.m_uid != it->uid,
+                            "Event " << ev.key.m_uid << " removed instead of " << it->uid);
+            break;
+        case 'c':
+            scheduler->Remove(ev);
+            break;
+        }
+    }
+}
+
 void
 Bench::Cb()
 {
@@ -171,32 +302,68 @@ class BenchSuite
     /**
      * Perform the runs for a single scheduler type.
      *
-     * This will create and set the scheduler, then execute a priming run
+     * This will create and set the scheduler, then execute the warmup runs
      * followed by the number of data runs requested.
      *
      * Output will be in the form of a table showing performance for each run.
      *
      * \param [in] factory Factory pre-configured to create the desired Scheduler.
-     * \param [in] pop The event population size.
-     * \param [in] total The total number of events to execute.
+     * \param [in] bench The benchmark to run.
+     * \param [in] warmup The number of warmup runs, which are not recorded.
      * \param [in] runs The number of replications.
-     * \param [in] eventStream The random stream of event delays.
      * \param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
      */
-    BenchSuite(ObjectFactory& factory,
-               uint64_t pop,
-               uint64_t total,
-               uint64_t runs,
-               Ptr<RandomVariableStream> eventStream,
-               bool calRev);
+    BenchSuite(ObjectFactory& factory, Bench& bench, uint64_t warmup, uint64_t runs, bool calRev);
 
     /** Write the results to \c LOG() */
     void Log() const;
 
+    /** Statistics of the times of a phase over the runs. */
+    struct Summary
+    {
+        double mean;  /**< Mean (s). */
+        double stdev; /**< Standard deviation (s). */
+        double min;   /**< Minimum (s). */
+        double p50;   /**< Median (s). */
+        double p90;   /**< 90th percentile (s). */
+        double p99;   /**< 99th percentile (s). */
+        double max;   /**< Maximum (s). */
+    };
+
+    /**
+     * Summarize the times of the initialization phase.
+     *
+     * \returns The statistics of the initialization times.
+     */
+    Summary SummarizeInit() const;
+
+    /**
+     * Summarize the times of the simulation phase.
+     *
+     * \returns The statistics of the simulation times.
+     */
+    Summary SummarizeRun() const;
+
+    /**
+     * Get the label identifying this scheduler in the machine-readable
+     * output and in the baseline.
+     *
+     * \returns The label.
+     */
+    std::string GetLabel() const;
+
   private:
     /** Print the table header. */
     void Header() const;
 
+    /**
+     * Summarize phase times.
+     *
+     * \param [in] times The times of a phase (s), one per run.
+     * \returns The statistics of the times.
+     */
+    static Summary Summarize(std::vector<double> times);
+
     /** Statistics from a single phase, init or run. */
     struct PhaseResult
     {
@@ -229,6 +396,7 @@ class BenchSuite
     }; // struct Result
 
     std::string m_scheduler;       /**< Descriptive string for the scheduler. */
+    std::string m_label;           /**< Label of the scheduler. */
     std::vector<Result> m_results; /**< Store for the run results. */
 
 }; // BenchSuite
@@ -254,41 +422,37 @@ BenchSuite::Result::Log(T label) const
 }
 
 BenchSuite::BenchSuite(ObjectFactory& factory,
-                       uint64_t pop,
-                       uint64_t total,
+                       Bench& bench,
+                       uint64_t warmup,
                        uint64_t runs,
-                       Ptr<RandomVariableStream> eventStream,
                        bool calRev)
 {
-    Simulator::SetScheduler(factory);
-
     m_scheduler = factory.GetTypeId().GetName();
+    m_label = m_scheduler;
     if (m_scheduler == "ns3::CalendarScheduler")
     {
         m_scheduler += ": insertion order: " + std::string(calRev ? "reverse" : "normal");
+        m_label += calRev ? "-reverse" : "";
     }
     if (m_scheduler == "ns3::MapScheduler")
     {
         m_scheduler += " (default)";
     }
 
-    Bench bench(pop, total);
-    bench.SetRandomStream(eventStream);
-    bench.SetPopulation(pop);
-    bench.SetTotal(total);
-
     m_results.reserve(runs);
     Header();
 
-    // Prime
-    DEB("priming");
-    auto prime = bench.Run();
-    Result::Bench(prime).Log("prime");
+    DEB("warming up");
+    for (uint64_t i = 0; i < warmup; i++)
+    {
+        auto run = bench.Run(factory);
+        Result::Bench(run).Log("warmup");
+    }
 
     // Perform the actual runs
     for (uint64_t i = 0; i < runs; i++)
     {
-        auto run = bench.Run();
+        auto run = bench.Run(factory);
         m_results.push_back(Result::Bench(run));
         m_results.back().Log(i);
     }
@@ -297,6 +461,71 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
 
 } // BenchSuite::Run
 
+std::string
+BenchSuite::GetLabel() const
+{
+    return m_label;
+}
+
+BenchSuite::Summary
+BenchSuite::SummarizeInit() const
+{
+    std::vector<double> times;
+    for (const auto& result : m_results)
+    {
+        times.push_back(result.init.time);
+    }
+    return Summarize(times);
+}
+
+BenchSuite::Summary
+BenchSuite::SummarizeRun() const
+{
+    std::vector<double> times;
+    for (const auto& result : m_results)
+    {
+        times.push_back(result.run.time);
+    }
+    return Summarize(times);
+}
+
+/* static */
+BenchSuite::Summary
+BenchSuite::Summarize(std::vector<double> times)
+{
+    if (times.empty())
+    {
+        return Summary{0, 0, 0, 0, 0, 0, 0};
+    }
+    std::sort(times.begin(), times.end());
+
+    double mean = 0;
+    for (auto time : times)
+    {
+        mean += time;
+    }
+    mean /= times.size();
+    double moment2 = 0;
+    for (auto time : times)
+    {
+        moment2 += (time - mean) * (time - mean);
+    }
+
+    // Nearest-rank percentiles
+    auto percentile = [&times](double p) {
+        auto rank = static_cast<std::size_t>(std::ceil(p / 100 * times.size()));
+        return times[std::max<std::size_t>(rank, 1) - 1];
+    };
+
+    return Summary{mean,
+                   std::sqrt(moment2 / times.size()),
+                   times.front(),
+                   percentile(50),
+                   percentile(90),
+                   percentile(99),
+                   times.back()};
+}
+
 void
 BenchSuite::Header() const
 {
@@ -440,20 +669,216 @@ GetRandomStream(std::string filename)
     return stream;
 }
 
+/**
+ *  Read a scheduler trace, as written by the RecordingScheduler.
+ *
+ *  \param [in] filename The trace file name.
+ *  \returns The trace.
+ */
+Trace
+ReadTrace(const std::string& filename)
+{
+    LOG("  Event trace:                  from " << filename);
+    std::ifstream input(filename);
+    NS_ABORT_MSG_UNLESS(input.is_open(), "Cannot open the trace file " << filename);
+
+    Trace trace;
+    TraceOp op;
+    while (input >> op.op >> op.ts >> op.uid)
+    {
+        NS_ABORT_MSG_UNLESS(op.op == 'i' || op.op == 'r' || op.op == 'c',
+                            "Unknown operation '" << op.op << "' in " << filename);
+        trace.push_back(op);
+    }
+    LOG("    Found " << trace.size() << " operations");
+    return trace;
+}
+
+/**
+ *  Write the statistics of the runs, as JSON if \p filename ends with
+ *  \c .json, and as CSV otherwise.
+ *
+ *  \param [in] filename The output file name.
+ *  \param [in] suites The results of each scheduler.
+ *  \param [in] workload The description of the event distribution.
+ *  \param [in] warmup The number of warmup runs.
+ *  \param [in] runs The number of runs.
+ */
+void
+WriteOutput(const std::string& filename,
+            const std::vector<BenchSuite>& suites,
+            const std::string& workload,
+            uint64_t warmup,
+            uint64_t runs)
+{
+    std::ofstream os(filename);
+    NS_ABORT_MSG_UNLESS(os.is_open(), "Cannot open the output file " << filename);
+    os << std::setprecision(9);
+    bool json = filename.ends_with(".json");
+
+    if (json)
+    {
+        os << "{\n"
+           << "  \"workload\": \"" << workload << "\",\n"
+           << "  \"warmup\": " << warmup << ",\n"
+           << "  \"runs\": " << runs << ",\n"
+           << "  \"results\": [\n";
+    }
+    else
+    {
+        os << "workload,scheduler,phase,runs,mean,stdev,min,p50,p90,p99,max\n";
+    }
+
+    bool first = true;
+    for (const auto& suite : suites)
+    {
+        for (const auto& [phase, summary] : {std::make_pair("init", suite.SummarizeInit()),
+                                             std::make_pair("run", suite.SummarizeRun())})
+        {
+            if (json)
+            {
+                // One result per line, which ReadBaseline() relies on
+                os << (first ? "" : ",\n") << "    {\"scheduler\": \"" << suite.GetLabel()
+                   << "\", \"phase\": \"" << phase << "\", \"mean\": " << summary.mean
+                   << ", \"stdev\": " << summary.stdev << ", \"min\": " << summary.min
+                   << ", \"p50\": " << summary.p50 << ", \"p90\": " << summary.p90
+                   << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "}";
+            }
+            else
+            {
+                os << workload << "," << suite.GetLabel() << "," << phase << "," << runs << ","
+                   << summary.mean << "," << summary.stdev << "," << summary.min << ","
+                   << summary.p50 << "," << summary.p90 << "," << summary.p99 << ","
+                   << summary.max << "\n";
+            }
+            first = false;
+        }
+    }
+
+    if (json)
+    {
+        os << "\n  ]\n}\n";
+    }
+    LOG("Wrote the results to " << filename);
+}
+
+/**
+ *  Read the mean simulation times from a file written by WriteOutput().
+ *
+ *  \param [in] filename The baseline file name.
+ *  \returns The mean simulation time (s) of each scheduler label.
+ */
+std::map<std::string, double>
+ReadBaseline(const std::string& filename)
+{
+    std::ifstream input(filename);
+    NS_ABORT_MSG_UNLESS(input.is_open(), "Cannot open the baseline file " << filename);
+    std::map<std::string, double> baseline;
+    std::string line;
+
+    if (filename.ends_with(".json"))
+    {
+        // The value of a field of a one-line JSON object
+        auto field = [&line](const std::string& key) {
+            auto pos = line.find("\"" + key + "\":");
+            if (pos == std::string::npos)
+            {
+                return std::string();
+            }
+            pos = line.find_first_not_of(" \"", pos + key.size() + 3);
+            return line.substr(pos, line.find_first_of("\",}", pos) - pos);
+        };
+        while (std::getline(input, line))
+        {
+            if (field("phase") == "run")
+            {
+                baseline[field("scheduler")] = std::stod(field("mean"));
+            }
+        }
+    }
+    else
+    {
+        // Skip the header, which WriteOutput() writes in a fixed order
+        std::getline(input, line);
+        while (std::getline(input, line))
+        {
+            std::vector<std::string> fields;
+            std::istringstream is(line);
+            std::string value;
+            while (std::getline(is, value, ','))
+            {
+                fields.push_back(value);
+            }
+            if (fields.size() > 4 && fields[2] == "run")
+            {
+                baseline[fields[1]] = std::stod(fields[4]);
+            }
+        }
+    }
+    return baseline;
+}
+
+/**
+ *  Compare the mean simulation times to a baseline.
+ *
+ *  \param [in] suites The results of each scheduler.
+ *  \param [in] baseline The baseline mean simulation times.
+ *  \param [in] threshold The relative slowdown from which a scheduler regressed.
+ *  \returns Whether a scheduler regressed.
+ */
+bool
+Compare(const std::vector<BenchSuite>& suites,
+        const std::map<std::string, double>& baseline,
+        double threshold)
+{
+    LOG("Comparison to the baseline, regression threshold " << threshold * 100 << "%");
+    LOG(std::left << std::setw(32) << "Scheduler" << std::setw(g_fwidth) << "Base (s)"
+                  << std::setw(g_fwidth) << "Now (s)" << "Change");
+    bool regressed = false;
+    for (const auto& suite : suites)
+    {
+        double current = suite.SummarizeRun().mean;
+        auto it = baseline.find(suite.GetLabel());
+        if (it == baseline.end())
+        {
+            LOG(std::left << std::setw(32) << suite.GetLabel() << std::setw(g_fwidth) << "-"
+                          << std::setw(g_fwidth) << current << "not in the baseline");
+            continue;
+        }
+        double change = current / it->second - 1;
+        bool regression = change > threshold;
+        regressed |= regression;
+        std::ostringstream percent;
+        percent << std::showpos << std::fixed << std::setprecision(1) << change * 100 << "%";
+        LOG(std::left << std::setw(32) << suite.GetLabel() << std::setw(g_fwidth) << it->second
+                      << std::setw(g_fwidth) << current << std::setw(10) << percent.str()
+                      << (regression ? "REGRESSION" : ""));
+    }
+    LOG("");
+    return regressed;
+}
+
 int
 main(int argc, char* argv[])
 {
     bool allSched = false;
+    bool schedAdaptive = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
 
     uint64_t pop = 100000;
     uint64_t total = 1000000;
+    uint64_t warmup = 1;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string traceFilename = "";
+    std::string outputFilename = "";
+    std::string baselineFilename = "";
+    double threshold = 0.1;
     bool calRev = false;
 
     CommandLine cmd(__FILE__);
@@ -466,19 +891,35 @@ main(int argc, char* argv[])
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
+              "Alternatively, the scheduler operations recorded by the\n"
+              "RecordingScheduler in a real simulation are replayed on\n"
+              "each scheduler, given by the --trace=\"<filename>\" argument.\n"
+              "\n"
+              "The statistics of the runs are written as JSON or CSV by\n"
+              "--output, and compared to a previous output by --baseline,\n"
+              "in which case the exit status is 1 if a scheduler is slower\n"
+              "than in the baseline by more than --threshold.\n"
+              "\n"
               "If no scheduler is specified the MapScheduler will be run.");
     cmd.AddValue("all", "use all schedulers", allSched);
+    cmd.AddValue("adaptive", "use AdaptiveScheduler", schedAdaptive);
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
     cmd.AddValue("debug", "enable debugging output", g_debug);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
+    cmd.AddValue("warmup", "number of warmup runs", warmup);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("trace", "scheduler trace to replay", traceFilename);
+    cmd.AddValue("output", "output file, .json for JSON, CSV otherwise", outputFilename);
+    cmd.AddValue("baseline", "output file of a previous run to compare to", baselineFilename);
+    cmd.AddValue("threshold", "relative slowdown from the baseline which fails", threshold);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
 
@@ -489,58 +930,101 @@ main(int argc, char* argv[])
     LOGME(" Benchmark the simulator scheduler");
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
+    LOG("  Number of warmup runs:        " << warmup);
     LOG("  Number of runs per scheduler: " << runs);
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedAdaptive = schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedAdaptive || schedCal || schedHeap || schedLadder || schedList || schedMap ||
+          schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    Bench bench(pop, total);
+    Trace trace;
+    std::string workload;
+    if (traceFilename.empty())
+    {
+        bench.SetRandomStream(GetRandomStream(filename));
+        workload = filename.empty() ? "exponential" : filename;
+    }
+    else
+    {
+        trace = ReadTrace(traceFilename);
+        bench.SetTrace(&trace);
+        workload = traceFilename;
+    }
+    std::vector<BenchSuite> suites;
 
     ObjectFactory factory("ns3::MapScheduler");
+    if (schedAdaptive)
+    {
+        factory.SetTypeId("ns3::AdaptiveScheduler");
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
+    }
     if (schedCal)
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            suites.emplace_back(factory, bench, warmup, runs, !calRev);
+            suites.back().Log();
         }
     }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
+    }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
     }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
-        auto listTotal = total;
         if (allSched)
         {
             LOG("Running List scheduler with 1/10 total events");
-            listTotal /= 10;
+            bench.SetTotal(total / 10);
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
+        bench.SetTotal(total);
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suites.emplace_back(factory, bench, warmup, runs, calRev);
+        suites.back().Log();
+    }
+
+    if (!outputFilename.empty())
+    {
+        WriteOutput(outputFilename, suites, workload, warmup, runs);
+    }
+    if (!baselineFilename.empty())
+    {
+        return Compare(suites, ReadBaseline(baselineFilename), threshold) ? 1 : 0;
     }
 
     return 0;
@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the Time arithmetic of the hot loops of the queue
+// discs and net devices, as computed with Time and int64x64_t and as
+// computed with the Ticks integer fast path.
+// Sample usage:  ./ns3 run 'bench-time --ops=10000000'
+
+#include "ns3/core-module.h"
+#include "ns3/data-rate.h"
+#include "ns3/time-ticks.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/** Output field width for numeric data. */
+const int g_fwidth = 14;
+
+/** Sink of the results, so that the compiler does not elide the loops. */
+volatile double g_sink = 0;
+
+/**
+ * Time a kernel.
+ *
+ * \param [in] kernel The kernel, which is called with the iteration number
+ * and returns a value to sink.
+ * \param [in] ops The number of iterations.
+ * \returns The average time (ns) per iteration.
+ */
+double
+Measure(const std::function<double(uint64_t)>& kernel, uint64_t ops)
+{
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < ops; i++)
+    {
+        sum += kernel(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink = g_sink + sum;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+/**
+ * Time the two implementations of a kernel and log the results.
+ *
+ * \param [in] name The name of the kernel.
+ * \param [in] slow The Time and int64x64_t implementation.
+ * \param [in] fast The Ticks implementation.
+ * \param [in] ops The number of iterations.
+ */
+void
+Compare(const std::string& name,
+        const std::function<double(uint64_t)>& slow,
+        const std::function<double(uint64_t)>& fast,
+        uint64_t ops)
+{
+    double slowNs = Measure(slow, ops);
+    double fastNs = Measure(fast, ops);
+    LOG(std::left << std::setw(24) << name << std::setw(g_fwidth) << slowNs << std::setw(g_fwidth)
+                  << fastNs << slowNs / fastNs);
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t ops = 10000000;
+    std::string rate = "10Gbps";
+    std::string interval = "1ms";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the Time arithmetic of the hot loops, with Time and\n"
+              "int64x64_t, and with the Ticks integer fast path.");
+    cmd.AddValue("ops", "number of iterations per kernel", ops);
+    cmd.AddValue("rate", "link rate", rate);
+    cmd.AddValue("interval", "rotation interval", interval);
+    cmd.Parse(argc, argv);
+
+    DataRate linkRate(rate);
+    uint64_t bps = linkRate.GetBitRate();
+    Time rotationInterval(interval);
+
+    // Inputs varying with the iteration number, so that nothing is folded
+    const uint32_t nInputs = 1024;
+    std::vector<Time> times;
+    std::vector<uint32_t> sizes;
+    for (uint32_t i = 0; i < nInputs; i++)
+    {
+        times.push_back(NanoSeconds(1000000 + i * 997));
+        sizes.push_back(64 + (i * 37) % 1437);
+    }
+    Time start = NanoSeconds(999000);
+
+    LOG("");
+    LOG(cmd.GetName() << ": Benchmark the Time arithmetic");
+    LOG("  Iterations per kernel:        " << ops);
+    LOG("  Rate:                         " << linkRate);
+    LOG("  Rotation interval:            " << rotationInterval.As(Time::MS));
+    LOG("");
+    LOG(std::left << std::setw(24) << "Kernel" << std::setw(g_fwidth) << "Time (ns)"
+                  << std::setw(g_fwidth) << "Ticks (ns)" << "Speedup");
+
+    Compare(
+        "remaining slot bytes",
+        [&](uint64_t i) {
+            Time remain = rotationInterval - (times[i % nInputs] - start);
+            return remain.GetSeconds() * bps / 8;
+        },
+        [&](uint64_t i) {
+            NanoTicks remain =
+                NanoTicks(rotationInterval) - (NanoTicks(times[i % nInputs]) - NanoTicks(start));
+            return remain.GetSeconds() * bps / 8;
+        },
+        ops);
+
+    Compare(
+        "transmission time",
+        [&](uint64_t i) {
+            Time txTime = Seconds(int64x64_t(sizes[i % nInputs] * 8) / bps);
+            return static_cast<double>(txTime.GetTimeStep());
+        },
+        [&](uint64_t i) {
+            Time txTime = linkRate.CalculateBytesTxTime(sizes[i % nInputs]);
+            return static_cast<double>(txTime.GetTimeStep());
+        },
+        ops);
+
+    Compare(
+        "delay in seconds",
+        [&](uint64_t i) { return (times[i % nInputs] - start).GetSeconds(); },
+        [&](uint64_t i) { return (NanoTicks(times[i % nInputs]) - NanoTicks(start)).GetSeconds(); },
+        ops);
+
+    return 0;
+}